@@ -0,0 +1,252 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+// Read throughput of a shared StudentManager as reader threads are added,
+// with one writer updating GPAs and adding students throughout. Compares
+// callers serializing on one external mutex against thread-safe mode.
+// Then insert throughput as producer threads are added, into one
+// thread-safe manager against a sharded manager with a shard per producer.
+//
+// Usage: concurrency_bench [students] [seconds_per_run] [max_readers]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "student_manager.h"
+#include "sharded_manager.h"
+
+#define MAX_READERS 64
+#define STATS_EVERY 64          // One statistics call per this many lookups
+#define WRITER_PAUSE_NS 20000   // Gap between writes
+
+typedef struct {
+    StudentManager* manager;
+    pthread_mutex_t* mutex;     // Set when callers serialize externally
+    int students;
+    atomic_int* stop;
+    unsigned long long operations;  // Lookups, or writes for the writer
+    unsigned int seed;
+} BenchThread;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned int next_random(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void* reader_thread(void* argument) {
+    BenchThread* self = argument;
+    unsigned long long reads = 0;
+    double checksum = 0.0;
+
+    while (!atomic_load(self->stop)) {
+        int id = (int)(next_random(&self->seed) % (unsigned int)self->students) + 1;
+        Student student;
+
+        if (self->mutex) pthread_mutex_lock(self->mutex);
+        if (get_student(self->manager, id, &student) == SUCCESS) {
+            checksum += student.gpa;
+        }
+        if (reads % STATS_EVERY == 0) {
+            checksum += calculate_average_gpa(self->manager) + calculate_highest_gpa(self->manager);
+        }
+        if (self->mutex) pthread_mutex_unlock(self->mutex);
+        reads++;
+    }
+
+    self->operations = reads + (checksum < 0.0);  // Keep the reads observable
+    return NULL;
+}
+
+static void* writer_thread(void* argument) {
+    BenchThread* self = argument;
+    struct timespec pause = {0, WRITER_PAUSE_NS};
+    int next_id = self->students + 1;
+
+    while (!atomic_load(self->stop)) {
+        unsigned int r = next_random(&self->seed);
+        int id = (int)(r % (unsigned int)self->students) + 1;
+        double gpa = (double)(r % 401) / 100.0;
+
+        if (self->mutex) pthread_mutex_lock(self->mutex);
+        if (r % 8 == 0 && next_id <= MAX_STUDENT_ID) {
+            add_student(self->manager, next_id++, "Added Student", gpa);
+        } else {
+            update_student_gpa(self->manager, id, gpa);
+        }
+        if (self->mutex) pthread_mutex_unlock(self->mutex);
+        self->operations++;
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+static StudentManager* build_roster(int students) {
+    StudentManager* manager = create_student_manager_with_capacity(students);
+    if (manager == NULL) {
+        return NULL;
+    }
+
+    unsigned int seed = 12345;
+    for (int id = 1; id <= students; id++) {
+        char name[MAX_NAME_LENGTH];
+        snprintf(name, sizeof(name), "Student %d", id);
+        add_student(manager, id, name, (double)(next_random(&seed) % 401) / 100.0);
+    }
+    return manager;
+}
+
+// Reads per second with `readers` reader threads and one writer
+static double run(int students, int readers, int thread_safe, double seconds) {
+    StudentManager* manager = build_roster(students);
+    if (manager == NULL) {
+        return 0.0;
+    }
+    set_student_thread_safe(manager, thread_safe);
+
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    atomic_int stop = 0;
+    BenchThread threads[MAX_READERS + 1];
+    pthread_t handles[MAX_READERS + 1];
+
+    for (int t = 0; t <= readers; t++) {
+        threads[t].manager = manager;
+        threads[t].mutex = thread_safe ? NULL : &mutex;
+        threads[t].students = students;
+        threads[t].stop = &stop;
+        threads[t].operations = 0;
+        threads[t].seed = 2463534242u + (unsigned int)t * 7919u;
+    }
+
+    double start = now_seconds();
+    pthread_create(&handles[0], NULL, writer_thread, &threads[0]);
+    for (int t = 1; t <= readers; t++) {
+        pthread_create(&handles[t], NULL, reader_thread, &threads[t]);
+    }
+
+    struct timespec duration = {(time_t)seconds, (long)((seconds - (double)(time_t)seconds) * 1e9)};
+    nanosleep(&duration, NULL);
+    atomic_store(&stop, 1);
+
+    unsigned long long reads = 0;
+    for (int t = 0; t <= readers; t++) {
+        pthread_join(handles[t], NULL);
+        if (t > 0) {
+            reads += threads[t].operations;
+        }
+    }
+    double elapsed = now_seconds() - start;
+
+    destroy_student_manager(manager);
+    pthread_mutex_destroy(&mutex);
+    return (double)reads / elapsed;
+}
+
+typedef struct {
+    StudentManager* manager;            // Either one shared manager...
+    ShardedStudentManager* sharded;     // ...or the sharded one
+    int first_id;
+    int count;
+} BenchProducer;
+
+static void* producer_thread(void* argument) {
+    BenchProducer* self = argument;
+    for (int id = self->first_id; id < self->first_id + self->count; id++) {
+        double gpa = (double)(id % 401) / 100.0;
+        if (self->sharded) {
+            sharded_add_student(self->sharded, id, "Added Student", gpa);
+        } else {
+            add_student(self->manager, id, "Added Student", gpa);
+        }
+    }
+    return NULL;
+}
+
+// Adds per second with `producers` threads inserting disjoint ID ranges
+static double ingest(int students, int producers, int sharded) {
+    StudentManager* manager = NULL;
+    ShardedStudentManager* shards = NULL;
+    if (sharded) {
+        shards = create_sharded_student_manager(producers, students);
+    } else if ((manager = create_student_manager_with_capacity(students)) != NULL) {
+        set_student_thread_safe(manager, 1);
+    }
+    if (manager == NULL && shards == NULL) {
+        return 0.0;
+    }
+
+    BenchProducer threads[MAX_READERS];
+    pthread_t handles[MAX_READERS];
+    int per_producer = students / producers;
+    for (int t = 0; t < producers; t++) {
+        threads[t].manager = manager;
+        threads[t].sharded = shards;
+        threads[t].first_id = 1 + t * per_producer;
+        threads[t].count = per_producer;
+    }
+
+    double start = now_seconds();
+    for (int t = 0; t < producers; t++) {
+        pthread_create(&handles[t], NULL, producer_thread, &threads[t]);
+    }
+    for (int t = 0; t < producers; t++) {
+        pthread_join(handles[t], NULL);
+    }
+    double elapsed = now_seconds() - start;
+
+    destroy_student_manager(manager);
+    destroy_sharded_student_manager(shards);
+    return (double)per_producer * producers / elapsed;
+}
+
+int main(int argc, char* argv[]) {
+    int students = argc > 1 ? atoi(argv[1]) : 100000;
+    double seconds = argc > 2 ? atof(argv[2]) : 0.5;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_readers = argc > 3 ? atoi(argv[3]) : (cpus > 1 ? (int)cpus : 2);
+
+    if (students <= 0 || students > MAX_STUDENT_ID || seconds <= 0.0 ||
+        max_readers <= 0 || max_readers > MAX_READERS) {
+        fprintf(stderr, "usage: %s [students] [seconds_per_run] [max_readers <= %d]\n",
+                argv[0], MAX_READERS);
+        return 1;
+    }
+
+    printf("%d students, %.2f s per run, %ld online CPUs, 1 writer\n", students, seconds, cpus);
+    printf("%-8s %16s %16s %8s\n", "readers", "mutex reads/s", "rwlock reads/s", "ratio");
+    // Powers of two, always finishing with max_readers
+    for (int readers = 1;; readers = readers * 2 < max_readers ? readers * 2 : max_readers) {
+        double serialized = run(students, readers, 0, seconds);
+        double shared = run(students, readers, 1, seconds);
+        printf("%-8d %16.0f %16.0f %7.2fx\n", readers, serialized, shared,
+               serialized > 0.0 ? shared / serialized : 0.0);
+        if (readers == max_readers) {
+            break;
+        }
+    }
+
+    printf("\n%-8s %16s %16s %8s\n", "writers", "1 lock adds/s", "sharded adds/s", "ratio");
+    for (int producers = 1;; producers = producers * 2 < max_readers ? producers * 2 : max_readers) {
+        double single = ingest(students, producers, 0);
+        double sharded = ingest(students, producers, 1);
+        printf("%-8d %16.0f %16.0f %7.2fx\n", producers, single, sharded,
+               single > 0.0 ? sharded / single : 0.0);
+        if (producers == max_readers) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -21,12 +21,14 @@
 
 // Application constants
 #define MAX_NAME_LENGTH 50
-#define MAX_STUDENTS 100
+#define INITIAL_STUDENT_CAPACITY 16
+#define MAX_STUDENT_ID 999999
 #define MIN_GPA 0.0
 #define MAX_GPA 4.0
 
 // File paths
 #define DEFAULT_STUDENT_FILE "students.txt"
+#define DEFAULT_SNAPSHOT_FILE "students.snap"
 #define LOG_FILE "application.log"
 
 // Error codes
@@ -36,5 +38,7 @@
 #define ERROR_INVALID_INPUT -3
 #define ERROR_STUDENT_NOT_FOUND -4
 #define ERROR_STUDENT_EXISTS -5
+#define ERROR_FILE_CORRUPT -6
+#define ERROR_FILE_IO -7
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include <stdint.h>
+#include <math.h>
+#include "gpa_kernels.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GPA_KERNELS_X86 1
+#include <immintrin.h>
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+typedef enum {
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+} KernelIsa;
+
+// The feature probe is a load of a flag word filled in at program start, so
+// it is cheap enough to repeat on every call and needs no shared state
+static KernelIsa detect_isa(void) {
+#ifdef GPA_KERNELS_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return KERNEL_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return KERNEL_SSE2;
+    }
+#endif
+    return KERNEL_SCALAR;
+}
+
+// Scalar versions: the portable fallback, and the tail of every vector loop
+
+// Neumaier running sum: the compensation collects what each addition
+// rounded away, so the total stays within a few rounding steps of exact
+typedef struct {
+    double sum;
+    double compensation;
+} CompensatedSum;
+
+static void compensated_add(CompensatedSum* total, double value) {
+    double sum = total->sum + value;
+    if (fabs(total->sum) >= fabs(value)) {
+        total->compensation += (total->sum - sum) + value;
+    } else {
+        total->compensation += (value - sum) + total->sum;
+    }
+    total->sum = sum;
+}
+
+static void sum_scalar(const double* values, size_t n, CompensatedSum* total) {
+    for (size_t i = 0; i < n; i++) {
+        compensated_add(total, values[i]);
+    }
+}
+
+// Scan values[start, n) continuing from the given running minimum/maximum
+static void min_max_scalar(const double* values, size_t start, size_t n,
+                           size_t* min_index, size_t* max_index) {
+    for (size_t i = start; i < n; i++) {
+        if (values[i] < values[*min_index]) *min_index = i;
+        if (values[i] > values[*max_index]) *max_index = i;
+    }
+}
+
+static size_t find_scalar(const double* values, size_t start, size_t n, double value) {
+    for (size_t i = start; i < n; i++) {
+        if (values[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+static size_t count_in_range_scalar(const double* values, size_t n, double min_value, double max_value) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += (values[i] >= min_value) & (values[i] <= max_value);
+    }
+    return count;
+}
+
+static void add_to_bucket(double value, double min_value, double max_value, double scale,
+                          size_t buckets, uint64_t* counts) {
+    if (value >= min_value && value <= max_value) {
+        size_t bucket = (size_t)((value - min_value) * scale);
+        counts[bucket < buckets ? bucket : buckets - 1]++;
+    }
+}
+
+#ifdef GPA_KERNELS_X86
+// Fold per-lane Kahan sums and their compensations into one total
+static void add_lanes(CompensatedSum* total, const double* sums, const double* compensations,
+                      int lanes) {
+    for (int lane = 0; lane < lanes; lane++) {
+        compensated_add(total, sums[lane]);
+        compensated_add(total, -compensations[lane]);
+    }
+}
+
+// SSE2: two lanes per vector
+TARGET_SSE2 static void sum_sse2(const double* values, size_t n, CompensatedSum* total) {
+    __m128d sum0 = _mm_setzero_pd(), error0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd(), error1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d y0 = _mm_sub_pd(_mm_loadu_pd(values + i), error0);
+        __m128d y1 = _mm_sub_pd(_mm_loadu_pd(values + i + 2), error1);
+        __m128d t0 = _mm_add_pd(sum0, y0);
+        __m128d t1 = _mm_add_pd(sum1, y1);
+        error0 = _mm_sub_pd(_mm_sub_pd(t0, sum0), y0);
+        error1 = _mm_sub_pd(_mm_sub_pd(t1, sum1), y1);
+        sum0 = t0;
+        sum1 = t1;
+    }
+    double sums[4], errors[4];
+    _mm_storeu_pd(sums, sum0);
+    _mm_storeu_pd(sums + 2, sum1);
+    _mm_storeu_pd(errors, error0);
+    _mm_storeu_pd(errors + 2, error1);
+    add_lanes(total, sums, errors, 4);
+    sum_scalar(values + i, n - i, total);
+}
+
+// Track the best value and its position per lane; a strict comparison keeps
+// the earliest position within a lane, and the final reduction prefers the
+// lower position on ties, so the overall result is the first occurrence
+TARGET_SSE2 static void min_max_sse2(const double* values, size_t n, size_t* min_index, size_t* max_index) {
+    __m128d position = _mm_set_pd(1.0, 0.0);
+    __m128d step = _mm_set1_pd(2.0);
+    __m128d min_value = _mm_loadu_pd(values);
+    __m128d max_value = min_value;
+    __m128d min_position = position;
+    __m128d max_position = position;
+
+    size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        position = _mm_add_pd(position, step);
+        __m128d x = _mm_loadu_pd(values + i);
+        __m128d less = _mm_cmplt_pd(x, min_value);
+        __m128d greater = _mm_cmpgt_pd(x, max_value);
+        min_value = _mm_or_pd(_mm_and_pd(less, x), _mm_andnot_pd(less, min_value));
+        min_position = _mm_or_pd(_mm_and_pd(less, position), _mm_andnot_pd(less, min_position));
+        max_value = _mm_or_pd(_mm_and_pd(greater, x), _mm_andnot_pd(greater, max_value));
+        max_position = _mm_or_pd(_mm_and_pd(greater, position), _mm_andnot_pd(greater, max_position));
+    }
+
+    double mins[2], min_positions[2], maxs[2], max_positions[2];
+    _mm_storeu_pd(mins, min_value);
+    _mm_storeu_pd(min_positions, min_position);
+    _mm_storeu_pd(maxs, max_value);
+    _mm_storeu_pd(max_positions, max_position);
+
+    int min_lane = mins[1] < mins[0] || (mins[1] == mins[0] && min_positions[1] < min_positions[0]);
+    int max_lane = maxs[1] > maxs[0] || (maxs[1] == maxs[0] && max_positions[1] < max_positions[0]);
+    *min_index = (size_t)min_positions[min_lane];
+    *max_index = (size_t)max_positions[max_lane];
+    min_max_scalar(values, i, n, min_index, max_index);
+}
+
+TARGET_SSE2 static size_t find_sse2(const double* values, size_t n, double value) {
+    __m128d target = _mm_set1_pd(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(values + i), target));
+        if (mask != 0) {
+            return i + (size_t)((mask & 1) ? 0 : 1);
+        }
+    }
+    return find_scalar(values, i, n, value);
+}
+
+// Comparison masks are all-ones (-1) per matching lane, so subtracting them
+// from an integer accumulator counts matches without branches
+TARGET_SSE2 static size_t count_in_range_sse2(const double* values, size_t n, double min_value, double max_value) {
+    __m128d low = _mm_set1_pd(min_value);
+    __m128d high = _mm_set1_pd(max_value);
+    __m128i count = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(values + i);
+        __m128d inside = _mm_and_pd(_mm_cmpge_pd(x, low), _mm_cmple_pd(x, high));
+        count = _mm_sub_epi64(count, _mm_castpd_si128(inside));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, count);
+    return (size_t)(lanes[0] + lanes[1]) + count_in_range_scalar(values + i, n - i, min_value, max_value);
+}
+
+TARGET_SSE2 static void histogram_sse2(const double* values, size_t n, double min_value, double max_value,
+                                       size_t buckets, uint64_t* counts) {
+    double scale = (double)buckets / (max_value - min_value);
+    __m128d low = _mm_set1_pd(min_value);
+    __m128d high = _mm_set1_pd(max_value);
+    __m128d factor = _mm_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(values + i);
+        int inside = _mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(x, low), _mm_cmple_pd(x, high)));
+        int32_t slots[4];
+        _mm_storeu_si128((__m128i*)slots, _mm_cvttpd_epi32(_mm_mul_pd(_mm_sub_pd(x, low), factor)));
+        for (int lane = 0; lane < 2; lane++) {
+            if (inside & (1 << lane)) {
+                size_t bucket = (size_t)slots[lane];
+                counts[bucket < buckets ? bucket : buckets - 1]++;
+            }
+        }
+    }
+    for (; i < n; i++) {
+        add_to_bucket(values[i], min_value, max_value, scale, buckets, counts);
+    }
+}
+
+// AVX2: four lanes per vector, same structure as the SSE2 versions
+TARGET_AVX2 static void sum_avx2(const double* values, size_t n, CompensatedSum* total) {
+    __m256d sum0 = _mm256_setzero_pd(), error0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd(), error1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d y0 = _mm256_sub_pd(_mm256_loadu_pd(values + i), error0);
+        __m256d y1 = _mm256_sub_pd(_mm256_loadu_pd(values + i + 4), error1);
+        __m256d t0 = _mm256_add_pd(sum0, y0);
+        __m256d t1 = _mm256_add_pd(sum1, y1);
+        error0 = _mm256_sub_pd(_mm256_sub_pd(t0, sum0), y0);
+        error1 = _mm256_sub_pd(_mm256_sub_pd(t1, sum1), y1);
+        sum0 = t0;
+        sum1 = t1;
+    }
+    double sums[8], errors[8];
+    _mm256_storeu_pd(sums, sum0);
+    _mm256_storeu_pd(sums + 4, sum1);
+    _mm256_storeu_pd(errors, error0);
+    _mm256_storeu_pd(errors + 4, error1);
+    add_lanes(total, sums, errors, 8);
+    sum_scalar(values + i, n - i, total);
+}
+
+TARGET_AVX2 static void min_max_avx2(const double* values, size_t n, size_t* min_index, size_t* max_index) {
+    __m256d position = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+    __m256d step = _mm256_set1_pd(4.0);
+    __m256d min_value = _mm256_loadu_pd(values);
+    __m256d max_value = min_value;
+    __m256d min_position = position;
+    __m256d max_position = position;
+
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        position = _mm256_add_pd(position, step);
+        __m256d x = _mm256_loadu_pd(values + i);
+        __m256d less = _mm256_cmp_pd(x, min_value, _CMP_LT_OQ);
+        __m256d greater = _mm256_cmp_pd(x, max_value, _CMP_GT_OQ);
+        min_value = _mm256_blendv_pd(min_value, x, less);
+        min_position = _mm256_blendv_pd(min_position, position, less);
+        max_value = _mm256_blendv_pd(max_value, x, greater);
+        max_position = _mm256_blendv_pd(max_position, position, greater);
+    }
+
+    double mins[4], min_positions[4], maxs[4], max_positions[4];
+    _mm256_storeu_pd(mins, min_value);
+    _mm256_storeu_pd(min_positions, min_position);
+    _mm256_storeu_pd(maxs, max_value);
+    _mm256_storeu_pd(max_positions, max_position);
+
+    int min_lane = 0, max_lane = 0;
+    for (int lane = 1; lane < 4; lane++) {
+        if (mins[lane] < mins[min_lane] ||
+            (mins[lane] == mins[min_lane] && min_positions[lane] < min_positions[min_lane])) {
+            min_lane = lane;
+        }
+        if (maxs[lane] > maxs[max_lane] ||
+            (maxs[lane] == maxs[max_lane] && max_positions[lane] < max_positions[max_lane])) {
+            max_lane = lane;
+        }
+    }
+    *min_index = (size_t)min_positions[min_lane];
+    *max_index = (size_t)max_positions[max_lane];
+    min_max_scalar(values, i, n, min_index, max_index);
+}
+
+TARGET_AVX2 static size_t find_avx2(const double* values, size_t n, double value) {
+    __m256d target = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(values + i), target, _CMP_EQ_OQ));
+        if (mask != 0) {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+    }
+    return find_scalar(values, i, n, value);
+}
+
+TARGET_AVX2 static size_t count_in_range_avx2(const double* values, size_t n, double min_value, double max_value) {
+    __m256d low = _mm256_set1_pd(min_value);
+    __m256d high = _mm256_set1_pd(max_value);
+    __m256i count = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(values + i);
+        __m256d inside = _mm256_and_pd(_mm256_cmp_pd(x, low, _CMP_GE_OQ),
+                                       _mm256_cmp_pd(x, high, _CMP_LE_OQ));
+        count = _mm256_sub_epi64(count, _mm256_castpd_si256(inside));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, count);
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+           count_in_range_scalar(values + i, n - i, min_value, max_value);
+}
+
+TARGET_AVX2 static void histogram_avx2(const double* values, size_t n, double min_value, double max_value,
+                                       size_t buckets, uint64_t* counts) {
+    double scale = (double)buckets / (max_value - min_value);
+    __m256d low = _mm256_set1_pd(min_value);
+    __m256d high = _mm256_set1_pd(max_value);
+    __m256d factor = _mm256_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(values + i);
+        int inside = _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(x, low, _CMP_GE_OQ),
+                                                      _mm256_cmp_pd(x, high, _CMP_LE_OQ)));
+        int32_t slots[4];
+        _mm_storeu_si128((__m128i*)slots,
+                         _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_sub_pd(x, low), factor)));
+        for (int lane = 0; lane < 4; lane++) {
+            if (inside & (1 << lane)) {
+                size_t bucket = (size_t)slots[lane];
+                counts[bucket < buckets ? bucket : buckets - 1]++;
+            }
+        }
+    }
+    for (; i < n; i++) {
+        add_to_bucket(values[i], min_value, max_value, scale, buckets, counts);
+    }
+}
+#endif // GPA_KERNELS_X86
+
+// Dispatch
+double gpa_kernel_sum(const double* values, size_t n) {
+    CompensatedSum total = {0.0, 0.0};
+#ifdef GPA_KERNELS_X86
+    switch (detect_isa()) {
+        case KERNEL_AVX2: sum_avx2(values, n, &total); break;
+        case KERNEL_SSE2: sum_sse2(values, n, &total); break;
+        default: sum_scalar(values, n, &total); break;
+    }
+#else
+    sum_scalar(values, n, &total);
+#endif
+    return total.sum + total.compensation;
+}
+
+void gpa_kernel_min_max(const double* values, size_t n, size_t* min_index, size_t* max_index) {
+    *min_index = 0;
+    *max_index = 0;
+#ifdef GPA_KERNELS_X86
+    KernelIsa isa = detect_isa();
+    if (isa == KERNEL_AVX2 && n >= 4) {
+        min_max_avx2(values, n, min_index, max_index);
+        return;
+    }
+    if (isa != KERNEL_SCALAR && n >= 2) {
+        min_max_sse2(values, n, min_index, max_index);
+        return;
+    }
+#endif
+    min_max_scalar(values, 1, n, min_index, max_index);
+}
+
+size_t gpa_kernel_find(const double* values, size_t n, double value) {
+#ifdef GPA_KERNELS_X86
+    switch (detect_isa()) {
+        case KERNEL_AVX2: return find_avx2(values, n, value);
+        case KERNEL_SSE2: return find_sse2(values, n, value);
+        default: break;
+    }
+#endif
+    return find_scalar(values, 0, n, value);
+}
+
+size_t gpa_kernel_count_in_range(const double* values, size_t n, double min_value, double max_value) {
+#ifdef GPA_KERNELS_X86
+    switch (detect_isa()) {
+        case KERNEL_AVX2: return count_in_range_avx2(values, n, min_value, max_value);
+        case KERNEL_SSE2: return count_in_range_sse2(values, n, min_value, max_value);
+        default: break;
+    }
+#endif
+    return count_in_range_scalar(values, n, min_value, max_value);
+}
+
+void gpa_kernel_histogram(const double* values, size_t n, double min_value, double max_value,
+                          size_t buckets, uint64_t* counts) {
+    if (buckets == 0 || !(max_value > min_value)) {
+        return;
+    }
+#ifdef GPA_KERNELS_X86
+    // Bucket numbers go through 32-bit conversions in the vector versions
+    if (buckets <= INT32_MAX) {
+        switch (detect_isa()) {
+            case KERNEL_AVX2: histogram_avx2(values, n, min_value, max_value, buckets, counts); return;
+            case KERNEL_SSE2: histogram_sse2(values, n, min_value, max_value, buckets, counts); return;
+            default: break;
+        }
+    }
+#endif
+    double scale = (double)buckets / (max_value - min_value);
+    for (size_t i = 0; i < n; i++) {
+        add_to_bucket(values[i], min_value, max_value, scale, buckets, counts);
+    }
+}
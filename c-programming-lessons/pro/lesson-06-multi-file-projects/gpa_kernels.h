@@ -0,0 +1,29 @@
+#ifndef GPA_KERNELS_H
+#define GPA_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Aggregate kernels over a contiguous array of GPAs. On x86 each call picks
+// an AVX2 or SSE2 implementation at run time from the CPU's feature flags
+// and falls back to plain C elsewhere. Inputs must not contain NaN.
+
+// Compensated sum, within a few rounding steps of the exact total. Lanes
+// are summed separately, so the last bit may differ from a sequential loop.
+double gpa_kernel_sum(const double* values, size_t n);
+
+// Positions of the first minimum and first maximum (both 0 when n == 0)
+void gpa_kernel_min_max(const double* values, size_t n, size_t* min_index, size_t* max_index);
+
+// Position of the first element equal to value, or n if there is none
+size_t gpa_kernel_find(const double* values, size_t n, double value);
+
+// Number of elements with min_value <= v <= max_value
+size_t gpa_kernel_count_in_range(const double* values, size_t n, double min_value, double max_value);
+
+// Add each element in [min_value, max_value] to one of `buckets` equal-width
+// buckets; max_value itself lands in the last one. counts is not cleared.
+void gpa_kernel_histogram(const double* values, size_t n, double min_value, double max_value,
+                          size_t buckets, uint64_t* counts);
+
+#endif // GPA_KERNELS_H
@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "id_index.h"
+#include "config.h"
+
+#define ID_INDEX_MIN_CAPACITY 16
+
+// Murmur3 finalizer: spreads both sequential and strided IDs across the table
+static size_t hash_id(int id, size_t capacity) {
+    uint32_t h = (uint32_t)id;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return (size_t)h & (capacity - 1);
+}
+
+static int needs_growth(const IdIndex* index, size_t new_count) {
+    // Keep the load factor at or below 70%
+    return new_count * 10 > index->capacity * 7;
+}
+
+static int rehash(IdIndex* index, size_t new_capacity) {
+    IdIndexEntry* entries = calloc(new_capacity, sizeof(IdIndexEntry));
+    if (entries == NULL) {
+        DEBUG_PRINT("Failed to allocate id index with %zu buckets", new_capacity);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    for (size_t i = 0; i < index->capacity; i++) {
+        IdIndexEntry entry = index->entries[i];
+        if (entry.id == 0) continue;
+
+        size_t pos = hash_id(entry.id, new_capacity);
+        while (entries[pos].id != 0) {
+            pos = (pos + 1) & (new_capacity - 1);
+        }
+        entries[pos] = entry;
+    }
+
+    free(index->entries);
+    index->entries = entries;
+    index->capacity = new_capacity;
+    return SUCCESS;
+}
+
+// Lifetime
+void id_index_init(IdIndex* index) {
+    index->entries = NULL;
+    index->capacity = 0;
+    index->count = 0;
+}
+
+void id_index_free(IdIndex* index) {
+    free(index->entries);
+    id_index_init(index);
+}
+
+void id_index_clear(IdIndex* index) {
+    for (size_t i = 0; i < index->capacity; i++) {
+        index->entries[i].id = 0;
+    }
+    index->count = 0;
+}
+
+int id_index_reserve(IdIndex* index, size_t expected_count) {
+    size_t capacity = index->capacity ? index->capacity : ID_INDEX_MIN_CAPACITY;
+    while (expected_count * 10 > capacity * 7) {
+        capacity *= 2;
+    }
+
+    if (capacity == index->capacity) {
+        return SUCCESS;
+    }
+    return rehash(index, capacity);
+}
+
+int id_index_shrink_to_fit(IdIndex* index) {
+    if (index->count == 0) {
+        id_index_free(index);
+        return SUCCESS;
+    }
+
+    size_t capacity = ID_INDEX_MIN_CAPACITY;
+    while (index->count * 10 > capacity * 7) {
+        capacity *= 2;
+    }
+
+    if (capacity >= index->capacity) {
+        return SUCCESS;
+    }
+    return rehash(index, capacity);
+}
+
+// Lookup and modification
+int id_index_find(const IdIndex* index, int id) {
+    if (index->count == 0 || id == 0) {
+        return -1;
+    }
+
+    size_t pos = hash_id(id, index->capacity);
+    while (index->entries[pos].id != 0) {
+        if (index->entries[pos].id == id) {
+            return index->entries[pos].slot;
+        }
+        pos = (pos + 1) & (index->capacity - 1);
+    }
+    return -1;
+}
+
+int id_index_insert(IdIndex* index, int id, int slot) {
+    if (id == 0) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    if (index->capacity == 0 || needs_growth(index, index->count + 1)) {
+        int result = id_index_reserve(index, index->count + 1);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+
+    size_t pos = hash_id(id, index->capacity);
+    while (index->entries[pos].id != 0) {
+        if (index->entries[pos].id == id) {
+            return ERROR_STUDENT_EXISTS;
+        }
+        pos = (pos + 1) & (index->capacity - 1);
+    }
+
+    index->entries[pos].id = id;
+    index->entries[pos].slot = slot;
+    index->count++;
+    return SUCCESS;
+}
+
+int id_index_remove(IdIndex* index, int id) {
+    if (index->count == 0 || id == 0) {
+        return ERROR_STUDENT_NOT_FOUND;
+    }
+
+    size_t mask = index->capacity - 1;
+    size_t pos = hash_id(id, index->capacity);
+    while (index->entries[pos].id != id) {
+        if (index->entries[pos].id == 0) {
+            return ERROR_STUDENT_NOT_FOUND;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    // Backward-shift deletion: pull later members of the probe run into the
+    // hole so lookups never need to skip over deleted markers
+    size_t hole = pos;
+    size_t next = (hole + 1) & mask;
+    while (index->entries[next].id != 0) {
+        size_t home = hash_id(index->entries[next].id, index->capacity);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index->entries[hole] = index->entries[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index->entries[hole].id = 0;
+    index->count--;
+    return SUCCESS;
+}
+
+void id_index_set_slot(IdIndex* index, int id, int slot) {
+    if (index->count == 0 || id == 0) {
+        return;
+    }
+
+    size_t pos = hash_id(id, index->capacity);
+    while (index->entries[pos].id != 0) {
+        if (index->entries[pos].id == id) {
+            index->entries[pos].slot = slot;
+            return;
+        }
+        pos = (pos + 1) & (index->capacity - 1);
+    }
+}
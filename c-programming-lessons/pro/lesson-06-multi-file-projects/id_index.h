@@ -0,0 +1,34 @@
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include <stddef.h>
+
+// Open-addressing hash index mapping a student ID to its slot in the
+// manager's record array. Valid student IDs are always positive, so an
+// entry with id 0 marks an empty bucket. Collisions use linear probing and
+// deletions use backward-shift, so the table never accumulates tombstones.
+typedef struct {
+    int id;
+    int slot;
+} IdIndexEntry;
+
+typedef struct {
+    IdIndexEntry* entries;
+    size_t capacity;    // Always zero or a power of two
+    size_t count;
+} IdIndex;
+
+// Lifetime
+void id_index_init(IdIndex* index);
+void id_index_free(IdIndex* index);
+void id_index_clear(IdIndex* index);
+int id_index_reserve(IdIndex* index, size_t expected_count);
+int id_index_shrink_to_fit(IdIndex* index);
+
+// Lookup and modification
+int id_index_find(const IdIndex* index, int id);
+int id_index_insert(IdIndex* index, int id, int slot);
+int id_index_remove(IdIndex* index, int id);
+void id_index_set_slot(IdIndex* index, int id, int slot);
+
+#endif // ID_INDEX_H
@@ -4,6 +4,7 @@
 #include "math_operations.h"
 #include "string_utils.h"
 #include "student_manager.h"
+#include "student_snapshot.h"
 #include "config.h"
 
 int main(void) {
@@ -114,6 +115,16 @@ int main(void) {
     printf("Highest GPA: %.2f\n", calculate_highest_gpa(manager));
     printf("Lowest GPA: %.2f\n", calculate_lowest_gpa(manager));
     
+    // Ordered views read the secondary indexes without moving records
+    printf("\nStudents with GPA between 3.50 and 4.00:\n");
+    StudentCursor cursor;
+    if (students_in_gpa_range(manager, 3.50, 4.00, &cursor) == SUCCESS) {
+        const Student *student;
+        while ((student = student_cursor_next(&cursor)) != NULL) {
+            display_student(student);
+        }
+    }
+    
     // Sort students
     printf("\nSorting students by GPA (descending):\n");
     sort_students_by_gpa(manager);
@@ -144,6 +155,15 @@ int main(void) {
         display_all_students(manager);
     }
     
+    // Round-trip through the binary snapshot format
+    printf("\nSaving binary snapshot and reloading it...\n");
+    if (save_students_snapshot(manager, DEFAULT_SNAPSHOT_FILE) == SUCCESS) {
+        clear_all_students(manager);
+        if (load_students_snapshot(manager, DEFAULT_SNAPSHOT_FILE) == SUCCESS) {
+            printf("Students after snapshot load: %d\n", get_student_count(manager));
+        }
+    }
+    
     // Clean up
     destroy_student_manager(manager);
     
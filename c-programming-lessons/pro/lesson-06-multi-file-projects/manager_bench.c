@@ -0,0 +1,545 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+// Single-threaded cost of the student_manager.h API at roster sizes from
+// 1e3 up to max_students, in both storage layouts. Prints one CSV row per
+// operation, size and layout, for diffing between builds:
+//
+//   operation,layout,students,ns_per_op,bytes_per_record
+//
+// ns_per_op is per call, except where a call handles many records (batch
+// add/remove, sorts, views, compaction, saves and loads), where it is per
+// record. remove_student is timed once per removal mode. Rows ending in
+// _unindexed repeat the statistics on a roster with the secondary indexes
+// turned off, so the scans they fall back to are tracked as well.
+// bytes_per_record is the heap held by the roster per student, or the file
+// size per student for save and load rows. Heap figures come from glibc's
+// allocator statistics and are 0 elsewhere.
+//
+// Usage: manager_bench [max_students]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "student_manager.h"
+#include "student_snapshot.h"
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_MALLINFO2 1
+#endif
+
+#define BENCH_MIN_SECONDS 0.05  // Repeat each measurement for at least this long
+#define BENCH_TEXT_FILE "bench_students.txt"
+#define BENCH_SNAPSHOT_FILE "bench_students.snap"
+#define BENCH_TOP_K 10
+#define BENCH_BUCKETS 10
+#define BENCH_REMOVALS 256      // Shifting removals are O(n) each, so time a few
+
+typedef struct {
+    StudentLayout layout;
+    int students;
+    Student* records;           // Roster in insertion order
+    int* ids;                   // The same IDs, shuffled, for lookups
+    StudentManager* roster;     // Built once, shared by read-only operations
+    StudentManager* unindexed;  // The same roster without secondary indexes
+    StudentManager* scratch;    // Rebuilt before each run of a destructive one
+} Bench;
+
+static volatile double sink;    // Keeps results observable
+
+typedef struct {
+    const char* name;
+    void (*setup)(Bench* bench);    // Untimed, before every run; may be NULL
+    long (*run)(Bench* bench);      // Returns the operations performed
+    const char* file;               // Reported size source, or NULL for heap
+} BenchOperation;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned int next_random(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static size_t heap_in_use(void) {
+#ifdef HAVE_MALLINFO2
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+static long file_size(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+// Roster generation
+static const char* const first_names[] = {
+    "Alice", "Bob", "Carol", "Dave", "Erin", "Frank", "Grace", "Heidi"
+};
+
+static int generate_roster(Bench* bench) {
+    int n = bench->students;
+    bench->records = malloc((size_t)n * sizeof(Student));
+    bench->ids = malloc((size_t)n * sizeof(int));
+    if (bench->records == NULL || bench->ids == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    // IDs 1..n in random order, so inserts and lookups do not walk memory
+    unsigned int seed = 2463534242u;
+    for (int i = 0; i < n; i++) {
+        bench->ids[i] = i + 1;
+    }
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(next_random(&seed) % (unsigned int)(i + 1));
+        int id = bench->ids[i];
+        bench->ids[i] = bench->ids[j];
+        bench->ids[j] = id;
+    }
+
+    for (int i = 0; i < n; i++) {
+        unsigned int r = next_random(&seed);
+        Student* student = &bench->records[i];
+        student->id = bench->ids[i];
+        snprintf(student->name, sizeof(student->name), "%s %u",
+                 first_names[r % 8], (r >> 3) % 100000);
+        student->gpa = (double)(r % 401) / 100.0;
+    }
+
+    // Lookups visit the IDs in a different random order than the inserts
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(next_random(&seed) % (unsigned int)(i + 1));
+        int id = bench->ids[i];
+        bench->ids[i] = bench->ids[j];
+        bench->ids[j] = id;
+    }
+    return SUCCESS;
+}
+
+static StudentManager* build_manager(const Bench* bench) {
+    StudentManager* manager = create_student_manager_with_layout(bench->layout, 0);
+    if (manager != NULL) {
+        add_students_batch(manager, bench->records, bench->students, NULL);
+    }
+    return manager;
+}
+
+// Setups
+static void fresh_scratch(Bench* bench) {
+    destroy_student_manager(bench->scratch);
+    bench->scratch = create_student_manager_with_layout(bench->layout, 0);
+}
+
+static void built_scratch(Bench* bench) {
+    destroy_student_manager(bench->scratch);
+    bench->scratch = build_manager(bench);
+}
+
+static void built_scratch_shift(Bench* bench) {
+    built_scratch(bench);
+    set_student_removal_mode(bench->scratch, STUDENT_REMOVE_SHIFT);
+}
+
+static void built_scratch_swap(Bench* bench) {
+    built_scratch(bench);
+    set_student_removal_mode(bench->scratch, STUDENT_REMOVE_SWAP);
+}
+
+static void built_scratch_tombstone(Bench* bench) {
+    built_scratch(bench);
+    set_student_removal_mode(bench->scratch, STUDENT_REMOVE_TOMBSTONE);
+}
+
+// Half the roster removed in tombstone mode, leaving holes for compaction
+// and spare capacity to shrink
+static void holed_scratch(Bench* bench) {
+    built_scratch_tombstone(bench);
+    remove_students_batch(bench->scratch, bench->ids, bench->students / 2, NULL);
+}
+
+// Each sort starts from the order another key leaves behind
+static void order_by_gpa(Bench* bench) {
+    sort_students_by_gpa(bench->roster);
+}
+
+static void order_by_id(Bench* bench) {
+    sort_students_by_id(bench->roster);
+}
+
+static void order_by_name(Bench* bench) {
+    sort_students_by_name(bench->roster);
+}
+
+// Operations
+static long run_add(Bench* bench) {
+    for (int i = 0; i < bench->students; i++) {
+        const Student* student = &bench->records[i];
+        add_student(bench->scratch, student->id, student->name, student->gpa);
+    }
+    return bench->students;
+}
+
+static long run_add_batch(Bench* bench) {
+    add_students_batch(bench->scratch, bench->records, bench->students, NULL);
+    return bench->students;
+}
+
+static long run_find_hit(Bench* bench) {
+    for (int i = 0; i < bench->students; i++) {
+        const Student* student = find_student(bench->roster, bench->ids[i]);
+        sink += student != NULL ? student->gpa : 0.0;
+    }
+    return bench->students;
+}
+
+// IDs past MAX_STUDENT_ID are never stored, so every probe misses
+static long run_find_miss(Bench* bench) {
+    for (int i = 0; i < bench->students; i++) {
+        sink += find_student(bench->roster, MAX_STUDENT_ID + bench->ids[i]) != NULL;
+    }
+    return bench->students;
+}
+
+static long run_get(Bench* bench) {
+    Student student;
+    for (int i = 0; i < bench->students; i++) {
+        if (get_student(bench->roster, bench->ids[i], &student) == SUCCESS) {
+            sink += student.gpa;
+        }
+    }
+    return bench->students;
+}
+
+static long run_update(Bench* bench) {
+    for (int i = 0; i < bench->students; i++) {
+        update_student_gpa(bench->roster, bench->ids[i], (double)(i % 401) / 100.0);
+    }
+    return bench->students;
+}
+
+static long run_remove(Bench* bench) {
+    int n = bench->students < BENCH_REMOVALS ? bench->students : BENCH_REMOVALS;
+    for (int i = 0; i < n; i++) {
+        remove_student(bench->scratch, bench->ids[i]);
+    }
+    return n;
+}
+
+static long run_remove_batch(Bench* bench) {
+    remove_students_batch(bench->scratch, bench->ids, bench->students, NULL);
+    return bench->students;
+}
+
+static long run_count(Bench* bench) {
+    sink += get_student_count(bench->roster);
+    return 1;
+}
+
+static long run_average(Bench* bench) {
+    sink += calculate_average_gpa(bench->roster);
+    return 1;
+}
+
+static long run_highest(Bench* bench) {
+    sink += calculate_highest_gpa(bench->roster);
+    return 1;
+}
+
+static long run_lowest(Bench* bench) {
+    sink += calculate_lowest_gpa(bench->roster);
+    return 1;
+}
+
+static long run_find_highest(Bench* bench) {
+    sink += find_student_with_highest_gpa(bench->roster) != NULL;
+    return 1;
+}
+
+static long run_find_lowest(Bench* bench) {
+    sink += find_student_with_lowest_gpa(bench->roster) != NULL;
+    return 1;
+}
+
+static long run_count_range(Bench* bench) {
+    sink += count_students_in_gpa_range(bench->roster, 2.0, 3.0);
+    return 1;
+}
+
+static long run_histogram(Bench* bench) {
+    int counts[BENCH_BUCKETS];
+    calculate_gpa_histogram(bench->roster, BENCH_BUCKETS, counts);
+    sink += counts[0];
+    return 1;
+}
+
+static long run_top_k(Bench* bench) {
+    Student top[BENCH_TOP_K];
+    sink += top_k_by_gpa(bench->roster, BENCH_TOP_K, top);
+    return 1;
+}
+
+static long run_percentile(Bench* bench) {
+    sink += gpa_percentile(bench->roster, 90.0);
+    return 1;
+}
+
+static long run_sort_by_id(Bench* bench) {
+    sort_students_by_id(bench->roster);
+    return bench->students;
+}
+
+static long run_sort_by_name(Bench* bench) {
+    sort_students_by_name(bench->roster);
+    return bench->students;
+}
+
+static long run_sort_by_gpa(Bench* bench) {
+    sort_students_by_gpa(bench->roster);
+    return bench->students;
+}
+
+// Best GPA first, ties by name: the multi-key path with a string key
+static long run_sort_gpa_desc_name(Bench* bench) {
+    static const StudentSortKey keys[] = {
+        {STUDENT_SORT_GPA, 1},
+        {STUDENT_SORT_NAME, 0},
+    };
+    sort_students(bench->roster, keys, 2);
+    return bench->students;
+}
+
+// Views report per record visited
+static long drain(StudentCursor* cursor) {
+    long visited = 0;
+    const Student* student;
+    while ((student = student_cursor_next(cursor)) != NULL) {
+        sink += student->gpa;
+        visited++;
+    }
+    return visited > 0 ? visited : 1;
+}
+
+static long run_view_by_gpa(Bench* bench) {
+    StudentCursor cursor;
+    students_by_gpa(bench->roster, 0, &cursor);
+    return drain(&cursor);
+}
+
+static long run_view_by_name(Bench* bench) {
+    StudentCursor cursor;
+    students_by_name(bench->roster, &cursor);
+    return drain(&cursor);
+}
+
+static long run_view_gpa_range(Bench* bench) {
+    StudentCursor cursor;
+    students_in_gpa_range(bench->roster, 2.0, 3.0, &cursor);
+    return drain(&cursor);
+}
+
+static long run_view_name_prefix(Bench* bench) {
+    StudentCursor cursor;
+    students_with_name_prefix(bench->roster, "Carol", &cursor);
+    return drain(&cursor);
+}
+
+static long run_compact(Bench* bench) {
+    compact_student_storage(bench->scratch);
+    return bench->students;
+}
+
+static long run_shrink(Bench* bench) {
+    shrink_student_manager_to_fit(bench->scratch);
+    return bench->students;
+}
+
+static long run_save_text(Bench* bench) {
+    save_students_to_file(bench->roster, BENCH_TEXT_FILE);
+    return bench->students;
+}
+
+static long run_load_text(Bench* bench) {
+    load_students_from_file(bench->scratch, BENCH_TEXT_FILE);
+    return bench->students;
+}
+
+static long run_save_snapshot(Bench* bench) {
+    save_students_snapshot(bench->roster, BENCH_SNAPSHOT_FILE);
+    return bench->students;
+}
+
+static long run_load_snapshot(Bench* bench) {
+    load_students_snapshot(bench->scratch, BENCH_SNAPSHOT_FILE);
+    return bench->students;
+}
+
+// Read-only operations come first; saves precede the matching loads
+static const BenchOperation operations[] = {
+    {"add_student", fresh_scratch, run_add, NULL},
+    {"add_students_batch", fresh_scratch, run_add_batch, NULL},
+    {"find_student_hit", NULL, run_find_hit, NULL},
+    {"find_student_miss", NULL, run_find_miss, NULL},
+    {"get_student", NULL, run_get, NULL},
+    {"get_student_count", NULL, run_count, NULL},
+    {"calculate_average_gpa", NULL, run_average, NULL},
+    {"calculate_highest_gpa", NULL, run_highest, NULL},
+    {"calculate_lowest_gpa", NULL, run_lowest, NULL},
+    {"find_student_with_highest_gpa", NULL, run_find_highest, NULL},
+    {"find_student_with_lowest_gpa", NULL, run_find_lowest, NULL},
+    {"count_students_in_gpa_range", NULL, run_count_range, NULL},
+    {"calculate_gpa_histogram", NULL, run_histogram, NULL},
+    {"top_k_by_gpa", NULL, run_top_k, NULL},
+    {"gpa_percentile", NULL, run_percentile, NULL},
+    {"students_by_gpa", NULL, run_view_by_gpa, NULL},
+    {"students_by_name", NULL, run_view_by_name, NULL},
+    {"students_in_gpa_range", NULL, run_view_gpa_range, NULL},
+    {"students_with_name_prefix", NULL, run_view_name_prefix, NULL},
+    {"update_student_gpa", NULL, run_update, NULL},
+    {"sort_students_by_id", order_by_gpa, run_sort_by_id, NULL},
+    {"sort_students_by_name", order_by_id, run_sort_by_name, NULL},
+    {"sort_students_by_gpa", order_by_name, run_sort_by_gpa, NULL},
+    {"sort_students_gpa_desc_name", order_by_id, run_sort_gpa_desc_name, NULL},
+    {"remove_student_shift", built_scratch_shift, run_remove, NULL},
+    {"remove_student_swap", built_scratch_swap, run_remove, NULL},
+    {"remove_student_tombstone", built_scratch_tombstone, run_remove, NULL},
+    {"remove_students_batch", built_scratch, run_remove_batch, NULL},
+    {"compact_student_storage", holed_scratch, run_compact, NULL},
+    {"shrink_student_manager_to_fit", holed_scratch, run_shrink, NULL},
+    {"save_students_to_file", NULL, run_save_text, BENCH_TEXT_FILE},
+    {"load_students_from_file", fresh_scratch, run_load_text, BENCH_TEXT_FILE},
+    {"save_students_snapshot", NULL, run_save_snapshot, BENCH_SNAPSHOT_FILE},
+    {"load_students_snapshot", fresh_scratch, run_load_snapshot, BENCH_SNAPSHOT_FILE},
+};
+
+// Statistics again, run against bench->unindexed
+static const BenchOperation unindexed_operations[] = {
+    {"calculate_average_gpa_unindexed", NULL, run_average, NULL},
+    {"calculate_highest_gpa_unindexed", NULL, run_highest, NULL},
+    {"calculate_lowest_gpa_unindexed", NULL, run_lowest, NULL},
+    {"find_student_with_highest_gpa_unindexed", NULL, run_find_highest, NULL},
+    {"find_student_with_lowest_gpa_unindexed", NULL, run_find_lowest, NULL},
+    {"count_students_in_gpa_range_unindexed", NULL, run_count_range, NULL},
+    {"calculate_gpa_histogram_unindexed", NULL, run_histogram, NULL},
+    {"top_k_by_gpa_unindexed", NULL, run_top_k, NULL},
+    {"gpa_percentile_unindexed", NULL, run_percentile, NULL},
+};
+
+// Runs without a setup are repeated in doubling batches between clock
+// reads, so that sub-microsecond calls are not swamped by the clock itself
+static double time_operation(Bench* bench, const BenchOperation* operation) {
+    double elapsed = 0.0;
+    long performed = 0;
+    long repeats = 1;
+
+    while (elapsed < BENCH_MIN_SECONDS) {
+        if (operation->setup != NULL) {
+            operation->setup(bench);
+        }
+        double start = now_seconds();
+        for (long r = 0; r < repeats; r++) {
+            performed += operation->run(bench);
+        }
+        elapsed += now_seconds() - start;
+        if (operation->setup == NULL) {
+            repeats *= 2;
+        }
+    }
+    return elapsed * 1e9 / (double)performed;
+}
+
+static void report_operations(Bench* bench, const BenchOperation* list, size_t count,
+                              double heap_per_record) {
+    const char* layout_name = bench->layout == STUDENT_LAYOUT_ROWS ? "rows" : "columns";
+    for (size_t i = 0; i < count; i++) {
+        double ns = time_operation(bench, &list[i]);
+        double bytes = list[i].file != NULL
+            ? (double)file_size(list[i].file) / bench->students : heap_per_record;
+        printf("%s,%s,%d,%.1f,%.1f\n", list[i].name, layout_name, bench->students, ns, bytes);
+        fflush(stdout);
+    }
+}
+
+static int bench_roster(StudentLayout layout, int students) {
+    Bench bench = {layout, students, NULL, NULL, NULL, NULL, NULL};
+    int result = generate_roster(&bench);
+
+    size_t heap_before = heap_in_use();
+    if (result == SUCCESS && (bench.roster = build_manager(&bench)) == NULL) {
+        result = ERROR_MEMORY_ALLOCATION;
+    }
+    double heap_per_record = (double)(heap_in_use() - heap_before) / students;
+    if (result == SUCCESS) {
+        report_operations(&bench, operations, sizeof(operations) / sizeof(operations[0]),
+                          heap_per_record);
+    }
+
+    // Built after the main pass so its heap is not counted above
+    heap_before = heap_in_use();
+    if (result == SUCCESS && ((bench.unindexed = build_manager(&bench)) == NULL ||
+                              set_student_indexes(bench.unindexed, 0) != SUCCESS)) {
+        result = ERROR_MEMORY_ALLOCATION;
+    }
+    heap_per_record = (double)(heap_in_use() - heap_before) / students;
+    if (result == SUCCESS) {
+        // The run functions read bench->roster
+        StudentManager* indexed = bench.roster;
+        bench.roster = bench.unindexed;
+        report_operations(&bench, unindexed_operations,
+                          sizeof(unindexed_operations) / sizeof(unindexed_operations[0]),
+                          heap_per_record);
+        bench.roster = indexed;
+    }
+
+    destroy_student_manager(bench.scratch);
+    destroy_student_manager(bench.unindexed);
+    destroy_student_manager(bench.roster);
+    free(bench.records);
+    free(bench.ids);
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    long max_students = argc > 1 ? atol(argv[1]) : 10000000;
+    if (max_students < 1000) {
+        fprintf(stderr, "usage: %s [max_students >= 1000]\n", argv[0]);
+        return 1;
+    }
+
+    printf("operation,layout,students,ns_per_op,bytes_per_record\n");
+    // Powers of ten; IDs stop at MAX_STUDENT_ID, which caps the last size
+    for (long size = 1000; size / 10 < max_students && size / 10 < MAX_STUDENT_ID; size *= 10) {
+        int students = (int)(size < max_students ? size : max_students);
+        if (students > MAX_STUDENT_ID) {
+            students = MAX_STUDENT_ID;
+        }
+        for (int layout = STUDENT_LAYOUT_ROWS; layout <= STUDENT_LAYOUT_COLUMNS; layout++) {
+            if (bench_roster((StudentLayout)layout, students) != SUCCESS) {
+                fprintf(stderr, "not enough memory for %d students\n", students);
+                return 1;
+            }
+        }
+    }
+
+    remove(BENCH_TEXT_FILE);
+    remove(BENCH_SNAPSHOT_FILE);
+    return 0;
+}
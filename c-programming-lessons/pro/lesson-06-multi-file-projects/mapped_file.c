@@ -0,0 +1,127 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mapped_file.h"
+#include "config.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+int sync_file(FILE* file) {
+    if (fflush(file) != 0) {
+        return ERROR_FILE_IO;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0 ? SUCCESS : ERROR_FILE_IO;
+#else
+    return fsync(fileno(file)) == 0 ? SUCCESS : ERROR_FILE_IO;
+#endif
+}
+
+#ifdef _WIN32
+// Portable fallback: slurp the file into memory
+int map_file_readonly(const char* path, MappedFile* file) {
+    file->data = NULL;
+    file->size = 0;
+    file->is_mapped = 0;
+
+    FILE* stream = fopen(path, "rb");
+    if (stream == NULL) {
+        DEBUG_PRINT("Failed to open file for reading: %s", path);
+        return ERROR_FILE_NOT_FOUND;
+    }
+
+    if (fseek(stream, 0, SEEK_END) != 0) {
+        fclose(stream);
+        return ERROR_FILE_IO;
+    }
+    long size = ftell(stream);
+    rewind(stream);
+    if (size < 0) {
+        fclose(stream);
+        return ERROR_FILE_IO;
+    }
+
+    void* buffer = malloc(size > 0 ? (size_t)size : 1);
+    if (buffer == NULL) {
+        fclose(stream);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    if (fread(buffer, 1, (size_t)size, stream) != (size_t)size) {
+        free(buffer);
+        fclose(stream);
+        return ERROR_FILE_IO;
+    }
+
+    fclose(stream);
+    file->data = buffer;
+    file->size = (size_t)size;
+    return SUCCESS;
+}
+
+void unmap_file(MappedFile* file) {
+    free((void*)file->data);
+    file->data = NULL;
+    file->size = 0;
+}
+#else
+int map_file_readonly(const char* path, MappedFile* file) {
+    file->data = NULL;
+    file->size = 0;
+    file->is_mapped = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        DEBUG_PRINT("Failed to open file for reading: %s", path);
+        return ERROR_FILE_NOT_FOUND;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 0) {
+        close(fd);
+        return ERROR_FILE_IO;
+    }
+
+    // mmap rejects zero-length mappings, so empty files get an empty view
+    if (info.st_size == 0) {
+        close(fd);
+        return SUCCESS;
+    }
+
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps its own reference to the file
+    if (data == MAP_FAILED) {
+        DEBUG_PRINT("Failed to map file: %s", path);
+        return ERROR_FILE_IO;
+    }
+
+#ifdef POSIX_MADV_SEQUENTIAL
+    posix_madvise(data, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+    file->data = data;
+    file->size = (size_t)info.st_size;
+    file->is_mapped = 1;
+    return SUCCESS;
+}
+
+void unmap_file(MappedFile* file) {
+    if (file->is_mapped) {
+        munmap((void*)file->data, file->size);
+    }
+    file->data = NULL;
+    file->size = 0;
+    file->is_mapped = 0;
+}
+#endif
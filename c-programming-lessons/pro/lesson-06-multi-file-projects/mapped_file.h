@@ -0,0 +1,23 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Read-only view of a whole file. On POSIX systems the file is mapped with
+// mmap so pages are faulted in lazily; elsewhere it is read into a heap buffer.
+typedef struct {
+    const void* data;
+    size_t size;
+    int is_mapped;      // 1 if data must be released with munmap
+} MappedFile;
+
+int map_file_readonly(const char* path, MappedFile* file);
+void unmap_file(MappedFile* file);
+
+// Flush a stream and ask the OS to put its data on disk, so that a rename
+// or truncation that follows cannot reach the disk before it does.
+// Returns SUCCESS or ERROR_FILE_IO.
+int sync_file(FILE* file);
+
+#endif // MAPPED_FILE_H
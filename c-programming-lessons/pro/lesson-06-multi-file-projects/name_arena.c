@@ -0,0 +1,283 @@
+#include <stdlib.h>
+#include <string.h>
+#include "name_arena.h"
+#include "config.h"
+
+#define INITIAL_ARENA_BYTES 1024
+#define INTERN_TABLE_MIN_CAPACITY 16
+
+_Static_assert(MAX_NAME_LENGTH - 1 <= UINT8_MAX, "name lengths must fit the length byte");
+
+// Lifetime
+void name_arena_init(NameArena* arena) {
+    arena->data = NULL;
+    arena->size = 0;
+    arena->capacity = 0;
+    arena->dead = 0;
+    arena->interning = 0;
+    arena->table = NULL;
+    arena->table_capacity = 0;
+    arena->table_count = 0;
+}
+
+void name_arena_free(NameArena* arena) {
+    free(arena->data);
+    free(arena->table);
+    name_arena_init(arena);
+}
+
+void name_arena_clear(NameArena* arena) {
+    arena->size = 0;
+    arena->dead = 0;
+    if (arena->table != NULL) {
+        memset(arena->table, 0, arena->table_capacity * sizeof(NameInternEntry));
+    }
+    arena->table_count = 0;
+}
+
+static int resize_arena(NameArena* arena, size_t capacity) {
+    if (capacity == 0) {
+        free(arena->data);
+        arena->data = NULL;
+        arena->capacity = 0;
+        return SUCCESS;
+    }
+
+    char* data = realloc(arena->data, capacity);
+    if (data == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    arena->data = data;
+    arena->capacity = capacity;
+    return SUCCESS;
+}
+
+// Intern table
+// FNV-1a over the characters
+static size_t hash_name(const char* name, size_t length, size_t capacity) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return (size_t)h & (capacity - 1);
+}
+
+static size_t hash_stored_name(const NameArena* arena, uint32_t offset, size_t capacity) {
+    return hash_name(name_arena_get(arena, offset), name_arena_length(arena, offset), capacity);
+}
+
+// Bucket holding the name, or the empty bucket where it would go
+static size_t find_bucket(const NameArena* arena, const char* name, size_t length) {
+    size_t mask = arena->table_capacity - 1;
+    size_t pos = hash_name(name, length, arena->table_capacity);
+    while (arena->table[pos].offset != 0) {
+        uint32_t offset = arena->table[pos].offset;
+        if (name_arena_length(arena, offset) == length &&
+            memcmp(name_arena_get(arena, offset), name, length) == 0) {
+            break;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+static int resize_table(NameArena* arena, size_t capacity) {
+    NameInternEntry* table = calloc(capacity, sizeof(NameInternEntry));
+    if (table == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    for (size_t i = 0; i < arena->table_capacity; i++) {
+        NameInternEntry entry = arena->table[i];
+        if (entry.offset == 0) {
+            continue;
+        }
+        size_t pos = hash_stored_name(arena, entry.offset, capacity);
+        while (table[pos].offset != 0) {
+            pos = (pos + 1) & (capacity - 1);
+        }
+        table[pos] = entry;
+    }
+
+    free(arena->table);
+    arena->table = table;
+    arena->table_capacity = capacity;
+    return SUCCESS;
+}
+
+// Keep the load factor at or below 70%, as the ID index does
+static int reserve_table(NameArena* arena, size_t names) {
+    size_t required = arena->table_count + names;
+    if (required * 10 <= arena->table_capacity * 7) {
+        return SUCCESS;
+    }
+
+    size_t capacity = arena->table_capacity > 0 ? arena->table_capacity : INTERN_TABLE_MIN_CAPACITY;
+    while (required * 10 > capacity * 7) {
+        capacity *= 2;
+    }
+    return resize_table(arena, capacity);
+}
+
+// Backward-shift deletion, as in the ID index
+static void remove_bucket(NameArena* arena, size_t pos) {
+    size_t mask = arena->table_capacity - 1;
+    size_t hole = pos;
+    size_t next = (hole + 1) & mask;
+    while (arena->table[next].offset != 0) {
+        size_t home = hash_stored_name(arena, arena->table[next].offset, arena->table_capacity);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            arena->table[hole] = arena->table[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    arena->table[hole].offset = 0;
+    arena->table[hole].references = 0;
+    arena->table_count--;
+}
+
+// Grow geometrically so that extra_bytes more can be appended; offsets are
+// 32-bit, so the arena never exceeds 4 GiB
+int name_arena_reserve(NameArena* arena, size_t names, size_t extra_bytes) {
+    if (arena->interning && reserve_table(arena, names) != SUCCESS) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    if (extra_bytes > (size_t)UINT32_MAX - arena->size) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    size_t required = arena->size + extra_bytes;
+    if (required <= arena->capacity) {
+        return SUCCESS;
+    }
+
+    size_t capacity = arena->capacity > 0 ? arena->capacity : INITIAL_ARENA_BYTES;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    if (capacity > (size_t)UINT32_MAX) {
+        capacity = (size_t)UINT32_MAX;
+    }
+    return resize_arena(arena, capacity);
+}
+
+int name_arena_shrink_to_fit(NameArena* arena) {
+    if (arena->capacity > arena->size) {
+        return resize_arena(arena, arena->size);
+    }
+    return SUCCESS;
+}
+
+int name_arena_set_interning(NameArena* arena, int enabled, uint32_t* offsets, size_t count) {
+    int previous = arena->interning;
+    if ((enabled != 0) == previous) {
+        return SUCCESS;
+    }
+
+    arena->interning = enabled != 0;
+    int result = name_arena_compact(arena, offsets, count);
+    if (result != SUCCESS) {
+        arena->interning = previous;
+    }
+    return result;
+}
+
+// Caller strings may be shorter than MAX_NAME_LENGTH, so scan byte by byte
+// rather than with memchr over a fixed length
+static size_t name_length(const char* name) {
+    size_t length = 0;
+    while (length < MAX_NAME_LENGTH - 1 && name[length] != '\0') {
+        length++;
+    }
+    return length;
+}
+
+size_t name_arena_stored_size(const char* name) {
+    return name_length(name) + 2;
+}
+
+// Names
+int name_arena_append(NameArena* arena, const char* name, uint32_t* offset) {
+    size_t length = name_length(name);
+    size_t bucket = 0;
+    if (arena->interning) {
+        if (reserve_table(arena, 1) != SUCCESS) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        bucket = find_bucket(arena, name, length);
+        if (arena->table[bucket].offset != 0) {
+            arena->table[bucket].references++;
+            *offset = arena->table[bucket].offset;
+            return SUCCESS;
+        }
+    }
+
+    int result = name_arena_reserve(arena, 0, length + 2);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    char* stored = arena->data + arena->size;
+    stored[0] = (char)length;
+    memcpy(stored + 1, name, length);
+    stored[length + 1] = '\0';
+    *offset = (uint32_t)arena->size + 1;
+    arena->size += length + 2;
+
+    if (arena->interning) {
+        arena->table[bucket].offset = *offset;
+        arena->table[bucket].references = 1;
+        arena->table_count++;
+    }
+    return SUCCESS;
+}
+
+void name_arena_release(NameArena* arena, uint32_t offset) {
+    size_t length = name_arena_length(arena, offset);
+    if (arena->interning) {
+        size_t bucket = find_bucket(arena, name_arena_get(arena, offset), length);
+        if (--arena->table[bucket].references > 0) {
+            return;
+        }
+        remove_bucket(arena, bucket);
+    }
+    arena->dead += length + 2;
+}
+
+void name_arena_truncate(NameArena* arena, size_t size) {
+    if (size < arena->size) {
+        arena->dead -= arena->size - size;
+        arena->size = size;
+    }
+}
+
+// Rewrite the names referenced by offsets[] back to back, in array order,
+// into a fresh arena sized up front so that no append can fail
+int name_arena_compact(NameArena* arena, uint32_t* offsets, size_t count) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        bytes += name_arena_length(arena, offsets[i]) + 2;
+    }
+
+    NameArena compacted;
+    name_arena_init(&compacted);
+    compacted.interning = arena->interning;
+    if (resize_arena(&compacted, bytes > 0 ? bytes : 1) != SUCCESS ||
+        (compacted.interning && reserve_table(&compacted, count) != SUCCESS)) {
+        name_arena_free(&compacted);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        name_arena_append(&compacted, name_arena_get(arena, offsets[i]), &offsets[i]);
+    }
+    // Shared names leave the sizing pass's upper bound partly unused
+    if (compacted.size > 0 && compacted.size < compacted.capacity) {
+        resize_arena(&compacted, compacted.size);
+    }
+
+    name_arena_free(arena);
+    *arena = compacted;
+    return SUCCESS;
+}
@@ -0,0 +1,67 @@
+#ifndef NAME_ARENA_H
+#define NAME_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Append-only buffer of student names addressed by 32-bit offsets. Each
+// name is stored as a length byte, the characters and a NUL, and its
+// offset points at the first character, so an offset is a handle to both
+// the text and its length. Released names leave dead bytes behind;
+// compaction rewrites the live names contiguously and updates the offsets
+// that refer to them.
+//
+// With interning on, equal names share one stored copy: appending a name
+// already present returns its offset and counts one more reference, and
+// its bytes only die with the last reference. Equal interned names then
+// have equal offsets. Offsets start at 1, so 0 marks an empty bucket of
+// the intern table, which probes linearly like the ID index.
+typedef struct {
+    uint32_t offset;
+    uint32_t references;
+} NameInternEntry;
+
+typedef struct {
+    char* data;
+    size_t size;        // Bytes in use, live or dead
+    size_t capacity;
+    size_t dead;        // Bytes belonging to released names
+    int interning;
+    NameInternEntry* table;     // Distinct live names while interning
+    size_t table_capacity;      // Always zero or a power of two
+    size_t table_count;
+} NameArena;
+
+// Lifetime
+void name_arena_init(NameArena* arena);
+void name_arena_free(NameArena* arena);
+void name_arena_clear(NameArena* arena);
+// Room for `names` more names totalling extra_bytes stored bytes
+int name_arena_reserve(NameArena* arena, size_t names, size_t extra_bytes);
+int name_arena_shrink_to_fit(NameArena* arena);
+// Switches interning and rewrites the names referenced by offsets[] to
+// match, sharing or unsharing their copies
+int name_arena_set_interning(NameArena* arena, int enabled, uint32_t* offsets, size_t count);
+
+// Bytes a name occupies once stored (truncated to MAX_NAME_LENGTH - 1 chars),
+// an upper bound when interning
+size_t name_arena_stored_size(const char* name);
+
+// Names
+// Once name_arena_reserve has covered them, appends cannot fail.
+// name_arena_truncate drops every name appended at or after size, all of
+// which must have been released already, e.g. to undo a failed insert.
+int name_arena_append(NameArena* arena, const char* name, uint32_t* offset);
+void name_arena_release(NameArena* arena, uint32_t offset);
+void name_arena_truncate(NameArena* arena, size_t size);
+int name_arena_compact(NameArena* arena, uint32_t* offsets, size_t count);
+
+static inline const char* name_arena_get(const NameArena* arena, uint32_t offset) {
+    return arena->data + offset;
+}
+
+static inline size_t name_arena_length(const NameArena* arena, uint32_t offset) {
+    return (unsigned char)arena->data[offset - 1];
+}
+
+#endif // NAME_ARENA_H
@@ -0,0 +1,450 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "ordered_index.h"
+#include "config.h"
+
+#define SLAB_BYTES (1u << 20)
+
+struct OrderedSlab {
+    OrderedSlab* next;
+    max_align_t data[];
+};
+
+_Static_assert((sizeof(OrderedNode) + ORDERED_INDEX_MAX_LEVEL * sizeof(OrderedNode*) +
+                ORDERED_INDEX_MAX_TEXT + 1) / sizeof(max_align_t) < ORDERED_INDEX_SIZE_CLASSES,
+               "free lists must cover the largest node");
+
+// Each extra level is taken with probability 1/4, which keeps the average
+// node at 1.33 forward links while still giving logarithmic searches
+static int random_level(OrderedIndex* index) {
+    uint32_t x = index->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    index->random_state = x;
+
+    int level = 1;
+    while ((x & 3) == 0 && level < ORDERED_INDEX_MAX_LEVEL) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+// Three-way comparison of a node against a probe entry: key first, then ID
+static int compare_node(const OrderedIndex* index, const OrderedNode* node, const OrderedEntry* probe) {
+    if (index->key_type == ORDERED_KEY_TEXT) {
+        int order = strcmp(node->text, probe->text);
+        if (order != 0) {
+            return order;
+        }
+    } else if (node->key != probe->key) {
+        return node->key < probe->key ? -1 : 1;
+    }
+    return (node->id > probe->id) - (node->id < probe->id);
+}
+
+// Nodes are sized in max_align_t units: the links plus, for text keys, the
+// NUL-terminated copy of the key
+static int size_class(int level, size_t text_length) {
+    size_t size = sizeof(OrderedNode) + (size_t)level * sizeof(OrderedNode*);
+    if (text_length > 0) {
+        size += text_length + 1;
+    }
+    return (int)((size + sizeof(max_align_t) - 1) / sizeof(max_align_t));
+}
+
+static OrderedNode* allocate_node(OrderedIndex* index, int size_class) {
+    OrderedNode* node = index->free_nodes[size_class];
+    if (node != NULL) {
+        index->free_nodes[size_class] = node->next[0];
+        return node;
+    }
+
+    size_t size = (size_t)size_class * sizeof(max_align_t);
+    size_t capacity = SLAB_BYTES - sizeof(OrderedSlab);
+    if (index->slabs == NULL || index->slab_used + size > capacity) {
+        OrderedSlab* slab = malloc(SLAB_BYTES);
+        if (slab == NULL) {
+            return NULL;
+        }
+        slab->next = index->slabs;
+        index->slabs = slab;
+        index->slab_used = 0;
+    }
+
+    node = (OrderedNode*)((char*)index->slabs->data + index->slab_used);
+    index->slab_used += size;
+    return node;
+}
+
+static void release_node(OrderedIndex* index, OrderedNode* node) {
+    node->next[0] = index->free_nodes[node->size_class];
+    index->free_nodes[node->size_class] = node;
+}
+
+static OrderedNode* create_node(OrderedIndex* index, int level, const OrderedEntry* entry) {
+    size_t text_length = 0;
+    if (index->key_type == ORDERED_KEY_TEXT) {
+        text_length = strlen(entry->text);
+    }
+
+    int node_class = size_class(level, text_length);
+    OrderedNode* node = allocate_node(index, node_class);
+    if (node == NULL) {
+        return NULL;
+    }
+
+    if (index->key_type == ORDERED_KEY_TEXT) {
+        char* text = (char*)&node->next[level];
+        memcpy(text, entry->text, text_length + 1);
+        node->text = text;
+    } else {
+        node->key = entry->key;
+    }
+    node->id = entry->id;
+    node->level = (unsigned short)level;
+    node->size_class = (unsigned short)node_class;
+    node->prev = NULL;
+    for (int i = 0; i < level; i++) {
+        node->next[i] = NULL;
+    }
+    return node;
+}
+
+static int ensure_head(OrderedIndex* index) {
+    if (index->head == NULL) {
+        index->head = malloc(sizeof(OrderedNode) + ORDERED_INDEX_MAX_LEVEL * sizeof(OrderedNode*));
+        if (index->head == NULL) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        index->head->text = NULL;
+        index->head->id = 0;
+        index->head->level = ORDERED_INDEX_MAX_LEVEL;
+        index->head->prev = NULL;
+        for (int i = 0; i < ORDERED_INDEX_MAX_LEVEL; i++) {
+            index->head->next[i] = NULL;
+        }
+    }
+    return SUCCESS;
+}
+
+// Fill update[] with the last node before the probe on every level
+static void find_predecessors(const OrderedIndex* index, const OrderedEntry* probe, OrderedNode** update) {
+    OrderedNode* node = index->head;
+    for (int level = index->level - 1; level >= 0; level--) {
+        while (node->next[level] != NULL && compare_node(index, node->next[level], probe) < 0) {
+            node = node->next[level];
+        }
+        update[level] = node;
+    }
+}
+
+// Lifetime
+void ordered_index_init(OrderedIndex* index, OrderedKeyType key_type) {
+    memset(index, 0, sizeof(*index));
+    index->key_type = key_type;
+    index->level = 1;
+    index->random_state = 0x9E3779B9u;
+}
+
+void ordered_index_free(OrderedIndex* index) {
+    OrderedSlab* slab = index->slabs;
+    while (slab != NULL) {
+        OrderedSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(index->head);
+    ordered_index_init(index, index->key_type);
+}
+
+void ordered_index_clear(OrderedIndex* index) {
+    // Dropping the slabs releases every node at once
+    OrderedNode* head = index->head;
+    index->head = NULL;
+    ordered_index_free(index);
+    index->head = head;
+
+    if (head != NULL) {
+        for (int i = 0; i < ORDERED_INDEX_MAX_LEVEL; i++) {
+            head->next[i] = NULL;
+        }
+    }
+}
+
+// Modification
+static int insert_entry(OrderedIndex* index, const OrderedEntry* entry) {
+    if (ensure_head(index) != SUCCESS) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    OrderedNode* update[ORDERED_INDEX_MAX_LEVEL];
+    find_predecessors(index, entry, update);
+
+    OrderedNode* successor = update[0]->next[0];
+    if (successor != NULL && compare_node(index, successor, entry) == 0) {
+        return ERROR_STUDENT_EXISTS;
+    }
+
+    int level = random_level(index);
+    OrderedNode* node = create_node(index, level, entry);
+    if (node == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    for (int i = index->level; i < level; i++) {
+        update[i] = index->head;
+    }
+    if (level > index->level) {
+        index->level = level;
+    }
+
+    for (int i = 0; i < level; i++) {
+        node->next[i] = update[i]->next[i];
+        update[i]->next[i] = node;
+    }
+
+    node->prev = update[0] == index->head ? NULL : update[0];
+    if (successor != NULL) {
+        successor->prev = node;
+    } else {
+        index->tail = node;
+    }
+
+    index->count++;
+    return SUCCESS;
+}
+
+static int remove_entry(OrderedIndex* index, const OrderedEntry* entry) {
+    if (index->head == NULL) {
+        return ERROR_STUDENT_NOT_FOUND;
+    }
+
+    OrderedNode* update[ORDERED_INDEX_MAX_LEVEL];
+    find_predecessors(index, entry, update);
+
+    OrderedNode* node = update[0]->next[0];
+    if (node == NULL || compare_node(index, node, entry) != 0) {
+        return ERROR_STUDENT_NOT_FOUND;
+    }
+
+    for (int i = 0; i < node->level; i++) {
+        update[i]->next[i] = node->next[i];
+    }
+
+    if (node->next[0] != NULL) {
+        node->next[0]->prev = node->prev;
+    } else {
+        index->tail = node->prev;
+    }
+
+    while (index->level > 1 && index->head->next[index->level - 1] == NULL) {
+        index->level--;
+    }
+
+    release_node(index, node);
+    index->count--;
+    return SUCCESS;
+}
+
+int ordered_index_insert(OrderedIndex* index, double key, int id) {
+    OrderedEntry entry = { .key = key, .id = id };
+    return insert_entry(index, &entry);
+}
+
+int ordered_index_remove(OrderedIndex* index, double key, int id) {
+    OrderedEntry entry = { .key = key, .id = id };
+    return remove_entry(index, &entry);
+}
+
+int ordered_index_insert_text(OrderedIndex* index, const char* text, int id) {
+    if (text == NULL || strlen(text) > ORDERED_INDEX_MAX_TEXT) {
+        return ERROR_INVALID_INPUT;
+    }
+    OrderedEntry entry = { .text = text, .id = id };
+    return insert_entry(index, &entry);
+}
+
+int ordered_index_remove_text(OrderedIndex* index, const char* text, int id) {
+    OrderedEntry entry = { .text = text, .id = id };
+    return remove_entry(index, &entry);
+}
+
+static int compare_number_entries(const void* a, const void* b) {
+    const OrderedEntry* entry_a = a;
+    const OrderedEntry* entry_b = b;
+    if (entry_a->key != entry_b->key) {
+        return entry_a->key < entry_b->key ? -1 : 1;
+    }
+    return (entry_a->id > entry_b->id) - (entry_a->id < entry_b->id);
+}
+
+static int compare_text_entries(const void* a, const void* b) {
+    const OrderedEntry* entry_a = a;
+    const OrderedEntry* entry_b = b;
+    int order = strcmp(entry_a->text, entry_b->text);
+    if (order != 0) {
+        return order;
+    }
+    return (entry_a->id > entry_b->id) - (entry_a->id < entry_b->id);
+}
+
+// Build a fresh list from sorted, unique entries in O(n) by always linking
+// at the current tail of each level
+static int build_from_sorted(OrderedIndex* index, const OrderedEntry* entries, size_t n) {
+    if (ensure_head(index) != SUCCESS) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    OrderedNode* last[ORDERED_INDEX_MAX_LEVEL];
+    for (int i = 0; i < ORDERED_INDEX_MAX_LEVEL; i++) {
+        last[i] = index->head;
+    }
+
+    OrderedNode* previous = NULL;
+    for (size_t i = 0; i < n; i++) {
+        int level = random_level(index);
+        OrderedNode* node = create_node(index, level, &entries[i]);
+        if (node == NULL) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        for (int l = 0; l < level; l++) {
+            last[l]->next[l] = node;
+            last[l] = node;
+        }
+        if (level > index->level) {
+            index->level = level;
+        }
+        node->prev = previous;
+        previous = node;
+    }
+
+    index->tail = previous;
+    index->count = n;
+    return SUCCESS;
+}
+
+int ordered_index_insert_many(OrderedIndex* index, OrderedEntry* entries, size_t n) {
+    if (n == 0) {
+        return SUCCESS;
+    }
+
+    int (*compare)(const void*, const void*) =
+        index->key_type == ORDERED_KEY_TEXT ? compare_text_entries : compare_number_entries;
+    qsort(entries, n, sizeof(OrderedEntry), compare);
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0 && compare(&entries[i - 1], &entries[i]) == 0) {
+            return ERROR_STUDENT_EXISTS;
+        }
+        if (index->key_type == ORDERED_KEY_TEXT &&
+            (entries[i].text == NULL || strlen(entries[i].text) > ORDERED_INDEX_MAX_TEXT)) {
+            return ERROR_INVALID_INPUT;
+        }
+    }
+
+    // Small additions to a large list: ordinary inserts, undone on failure
+    if (n < index->count / 4) {
+        for (size_t i = 0; i < n; i++) {
+            int result = insert_entry(index, &entries[i]);
+            if (result != SUCCESS) {
+                while (i-- > 0) {
+                    remove_entry(index, &entries[i]);
+                }
+                return result;
+            }
+        }
+        return SUCCESS;
+    }
+
+    // Otherwise merge the existing entries with the new ones and rebuild,
+    // swapping the result in only once it is complete. Text entries taken
+    // from the old nodes stay valid until the old index is freed.
+    size_t total = index->count + n;
+    OrderedEntry* merged = malloc(total * sizeof(OrderedEntry));
+    if (merged == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    const OrderedNode* node = ordered_index_first(index);
+    size_t out = 0, next_new = 0;
+    while (node != NULL || next_new < n) {
+        int order = node == NULL ? 1 : next_new == n ? -1 : compare_node(index, node, &entries[next_new]);
+        if (order < 0) {
+            if (index->key_type == ORDERED_KEY_TEXT) {
+                merged[out].text = node->text;
+            } else {
+                merged[out].key = node->key;
+            }
+            merged[out].id = node->id;
+            node = node->next[0];
+        } else {
+            if (order == 0) {
+                free(merged);
+                return ERROR_STUDENT_EXISTS;
+            }
+            merged[out] = entries[next_new++];
+        }
+        out++;
+    }
+
+    OrderedIndex rebuilt;
+    ordered_index_init(&rebuilt, index->key_type);
+    rebuilt.random_state = index->random_state;
+    int result = build_from_sorted(&rebuilt, merged, total);
+    free(merged);
+    if (result != SUCCESS) {
+        ordered_index_free(&rebuilt);
+        return result;
+    }
+
+    ordered_index_free(index);
+    *index = rebuilt;
+    return SUCCESS;
+}
+
+// Navigation
+const OrderedNode* ordered_index_first(const OrderedIndex* index) {
+    return index->head != NULL ? index->head->next[0] : NULL;
+}
+
+const OrderedNode* ordered_index_last(const OrderedIndex* index) {
+    return index->tail;
+}
+
+const OrderedNode* ordered_index_next(const OrderedIndex* index, const OrderedNode* node) {
+    (void)index;
+    return node != NULL ? node->next[0] : NULL;
+}
+
+const OrderedNode* ordered_index_prev(const OrderedIndex* index, const OrderedNode* node) {
+    (void)index;
+    return node != NULL ? node->prev : NULL;
+}
+
+// The probe carries INT_MIN as its ID, so it sorts before every real entry
+// with an equal key
+static const OrderedNode* lower_bound_entry(const OrderedIndex* index, const OrderedEntry* probe) {
+    if (index->head == NULL) {
+        return NULL;
+    }
+
+    const OrderedNode* node = index->head;
+    for (int level = index->level - 1; level >= 0; level--) {
+        while (node->next[level] != NULL && compare_node(index, node->next[level], probe) < 0) {
+            node = node->next[level];
+        }
+    }
+    return node->next[0];
+}
+
+const OrderedNode* ordered_index_lower_bound(const OrderedIndex* index, double key) {
+    OrderedEntry probe = { .key = key, .id = INT_MIN };
+    return lower_bound_entry(index, &probe);
+}
+
+const OrderedNode* ordered_index_lower_bound_text(const OrderedIndex* index, const char* text) {
+    OrderedEntry probe = { .text = text, .id = INT_MIN };
+    return lower_bound_entry(index, &probe);
+}
@@ -0,0 +1,79 @@
+#ifndef ORDERED_INDEX_H
+#define ORDERED_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Skip list of (key, student ID) pairs kept in ascending key order, with the
+// ID breaking ties so every entry is unique. Keys are either numbers or
+// strings (compared bytewise); text keys are copied into the index, so it
+// never points into the manager's movable record array. Level 0 is doubly
+// linked, which gives O(1) access to both ends and cheap iteration in either
+// direction; insert, remove and lower-bound searches take O(log n) expected.
+#define ORDERED_INDEX_MAX_LEVEL 32
+#define ORDERED_INDEX_MAX_TEXT 255
+#define ORDERED_INDEX_SIZE_CLASSES 96
+
+typedef enum {
+    ORDERED_KEY_NUMBER,
+    ORDERED_KEY_TEXT
+} OrderedKeyType;
+
+typedef struct OrderedNode {
+    union {
+        double key;                 // ORDERED_KEY_NUMBER
+        const char* text;           // ORDERED_KEY_TEXT, stored after next[]
+    };
+    int id;
+    unsigned short level;
+    unsigned short size_class;
+    struct OrderedNode* prev;
+    struct OrderedNode* next[];     // level entries
+} OrderedNode;
+
+// Nodes are carved out of large slabs and recycled through per-size free
+// lists, so inserts avoid a malloc call and carry no allocator header
+typedef struct OrderedSlab OrderedSlab;
+
+typedef struct {
+    OrderedKeyType key_type;
+    OrderedNode* head;              // Sentinel holding ORDERED_INDEX_MAX_LEVEL links
+    OrderedNode* tail;
+    int level;
+    size_t count;
+    uint32_t random_state;
+    OrderedSlab* slabs;
+    size_t slab_used;               // Bytes handed out from the newest slab
+    OrderedNode* free_nodes[ORDERED_INDEX_SIZE_CLASSES];
+} OrderedIndex;
+
+// Input for bulk insertion
+typedef struct {
+    union {
+        double key;
+        const char* text;
+    };
+    int id;
+} OrderedEntry;
+
+// Lifetime
+void ordered_index_init(OrderedIndex* index, OrderedKeyType key_type);
+void ordered_index_free(OrderedIndex* index);
+void ordered_index_clear(OrderedIndex* index);
+
+// Modification
+int ordered_index_insert(OrderedIndex* index, double key, int id);
+int ordered_index_remove(OrderedIndex* index, double key, int id);
+int ordered_index_insert_text(OrderedIndex* index, const char* text, int id);
+int ordered_index_remove_text(OrderedIndex* index, const char* text, int id);
+int ordered_index_insert_many(OrderedIndex* index, OrderedEntry* entries, size_t n);
+
+// Navigation
+const OrderedNode* ordered_index_first(const OrderedIndex* index);
+const OrderedNode* ordered_index_last(const OrderedIndex* index);
+const OrderedNode* ordered_index_next(const OrderedIndex* index, const OrderedNode* node);
+const OrderedNode* ordered_index_prev(const OrderedIndex* index, const OrderedNode* node);
+const OrderedNode* ordered_index_lower_bound(const OrderedIndex* index, double key);
+const OrderedNode* ordered_index_lower_bound_text(const OrderedIndex* index, const char* text);
+
+#endif // ORDERED_INDEX_H
@@ -0,0 +1,74 @@
+// glibc only offers writer preference as an extension
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include "rw_lock.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+struct RwLock {
+#ifdef _WIN32
+    SRWLOCK lock;
+#else
+    pthread_rwlock_t lock;
+#endif
+};
+
+// Lifetime
+RwLock* rw_lock_create(void) {
+    RwLock* lock = malloc(sizeof(RwLock));
+    if (lock == NULL) {
+        return NULL;
+    }
+
+#ifdef _WIN32
+    InitializeSRWLock(&lock->lock);
+#else
+    // A steady stream of readers must not starve writers; glibc prefers
+    // readers unless told otherwise
+    pthread_rwlockattr_t attributes;
+    pthread_rwlockattr_init(&attributes);
+#ifdef __GLIBC__
+    pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    int result = pthread_rwlock_init(&lock->lock, &attributes);
+    pthread_rwlockattr_destroy(&attributes);
+    if (result != 0) {
+        free(lock);
+        return NULL;
+    }
+#endif
+    return lock;
+}
+
+void rw_lock_destroy(RwLock* lock) {
+    if (lock == NULL) {
+        return;
+    }
+#ifndef _WIN32
+    pthread_rwlock_destroy(&lock->lock);
+#endif
+    free(lock);
+}
+
+// Locking
+#ifdef _WIN32
+void rw_lock_read(RwLock* lock) { AcquireSRWLockShared(&lock->lock); }
+void rw_lock_read_unlock(RwLock* lock) { ReleaseSRWLockShared(&lock->lock); }
+void rw_lock_write(RwLock* lock) { AcquireSRWLockExclusive(&lock->lock); }
+void rw_lock_write_unlock(RwLock* lock) { ReleaseSRWLockExclusive(&lock->lock); }
+#else
+void rw_lock_read(RwLock* lock) { pthread_rwlock_rdlock(&lock->lock); }
+void rw_lock_read_unlock(RwLock* lock) { pthread_rwlock_unlock(&lock->lock); }
+void rw_lock_write(RwLock* lock) { pthread_rwlock_wrlock(&lock->lock); }
+void rw_lock_write_unlock(RwLock* lock) { pthread_rwlock_unlock(&lock->lock); }
+#endif
@@ -0,0 +1,19 @@
+#ifndef RW_LOCK_H
+#define RW_LOCK_H
+
+// Reader-writer lock: any number of readers or one writer. Wraps a POSIX
+// rwlock that favors waiting writers where the platform allows, or an SRW
+// lock on Windows. Neither mode is recursive.
+typedef struct RwLock RwLock;
+
+// Lifetime
+RwLock* rw_lock_create(void);
+void rw_lock_destroy(RwLock* lock);
+
+// Locking
+void rw_lock_read(RwLock* lock);
+void rw_lock_read_unlock(RwLock* lock);
+void rw_lock_write(RwLock* lock);
+void rw_lock_write_unlock(RwLock* lock);
+
+#endif // RW_LOCK_H
@@ -0,0 +1,332 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "sharded_manager.h"
+#include "student_manager_internal.h"
+#include "config.h"
+
+struct ShardedStudentManager {
+    int shard_count;
+    StudentManager* shards[];
+};
+
+// Fibonacci hashing rather than the ID index's Murmur finalizer, so the
+// IDs that share a shard still spread evenly over that shard's hash table
+static int shard_for_id(const ShardedStudentManager* manager, int id) {
+    uint32_t h = (uint32_t)id * 2654435769u;
+    return (int)(((uint64_t)h * (uint64_t)manager->shard_count) >> 32);
+}
+
+// Rank order of top-K results: higher GPA first, ties to the lower ID
+static int ranks_before(const Student* a, const Student* b) {
+    return a->gpa > b->gpa || (a->gpa == b->gpa && a->id < b->id);
+}
+
+// Constructor and destructor
+ShardedStudentManager* create_sharded_student_manager(int shards, int capacity_hint) {
+    DEBUG_PRINT("Creating sharded student manager (%d shards)", shards);
+
+    if (shards <= 0 || shards > MAX_STUDENT_SHARDS) {
+        DEBUG_PRINT("Invalid shard count: %d", shards);
+        return NULL;
+    }
+
+    ShardedStudentManager* manager = calloc(1, sizeof(ShardedStudentManager) +
+                                               (size_t)shards * sizeof(StudentManager*));
+    if (manager == NULL) {
+        return NULL;
+    }
+
+    // The hash spreads IDs evenly, so each shard is sized for its share
+    int shard_hint = capacity_hint > 0 ? capacity_hint / shards + 1 : 0;
+    for (int i = 0; i < shards; i++) {
+        manager->shards[i] = create_student_manager_with_capacity(shard_hint);
+        if (manager->shards[i] == NULL || set_student_thread_safe(manager->shards[i], 1) != SUCCESS) {
+            manager->shard_count = i + 1;
+            destroy_sharded_student_manager(manager);
+            return NULL;
+        }
+    }
+    manager->shard_count = shards;
+    return manager;
+}
+
+void destroy_sharded_student_manager(ShardedStudentManager* manager) {
+    if (manager != NULL) {
+        for (int i = 0; i < manager->shard_count; i++) {
+            destroy_student_manager(manager->shards[i]);
+        }
+        free(manager);
+    }
+}
+
+// Shard access
+int get_student_shard_count(const ShardedStudentManager* manager) {
+    return manager != NULL ? manager->shard_count : 0;
+}
+
+StudentManager* get_student_shard(ShardedStudentManager* manager, int shard) {
+    if (manager == NULL || shard < 0 || shard >= manager->shard_count) {
+        return NULL;
+    }
+    return manager->shards[shard];
+}
+
+int student_shard_for_id(const ShardedStudentManager* manager, int id) {
+    if (manager == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+    return shard_for_id(manager, id);
+}
+
+// Student management functions
+int sharded_add_student(ShardedStudentManager* manager, int id, const char* name, double gpa) {
+    if (manager == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+    return add_student(manager->shards[shard_for_id(manager, id)], id, name, gpa);
+}
+
+int sharded_remove_student(ShardedStudentManager* manager, int id) {
+    if (manager == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+    return remove_student(manager->shards[shard_for_id(manager, id)], id);
+}
+
+Student* sharded_find_student(ShardedStudentManager* manager, int id) {
+    if (manager == NULL) {
+        return NULL;
+    }
+    return find_student(manager->shards[shard_for_id(manager, id)], id);
+}
+
+int sharded_get_student(ShardedStudentManager* manager, int id, Student* student) {
+    if (manager == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+    return get_student(manager->shards[shard_for_id(manager, id)], id, student);
+}
+
+int sharded_update_student_gpa(ShardedStudentManager* manager, int id, double new_gpa) {
+    if (manager == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+    return update_student_gpa(manager->shards[shard_for_id(manager, id)], id, new_gpa);
+}
+
+int sharded_get_student_count(ShardedStudentManager* manager) {
+    int count = 0;
+    for (int i = 0; manager != NULL && i < manager->shard_count; i++) {
+        count += get_student_count(manager->shards[i]);
+    }
+    return count;
+}
+
+// Bulk insert. A counting pass groups the rows by shard, keeping their
+// order within each group, and origins[] maps each grouped row back to its
+// position in the caller's batch for the error bitmap.
+int sharded_add_students_batch(ShardedStudentManager* manager, const Student* students, int n,
+                               StudentBatchReport* report) {
+    DEBUG_PRINT("Adding sharded batch of %d students", n);
+
+    if (manager == NULL || (students == NULL && n > 0) || n < 0) {
+        DEBUG_PRINT("Invalid parameters for sharded_add_students_batch");
+        return ERROR_INVALID_INPUT;
+    }
+
+    StudentBatchReport local = {0, 0, 0, NULL};
+    if (report == NULL) {
+        report = &local;
+    }
+    report->added = 0;
+    report->invalid = 0;
+    report->duplicates = 0;
+    if (report->error_bitmap != NULL) {
+        memset(report->error_bitmap, 0, ((size_t)n + 63) / 64 * sizeof(uint64_t));
+    }
+    if (n == 0) {
+        return SUCCESS;
+    }
+
+    int starts[MAX_STUDENT_SHARDS + 1] = {0};
+    int* shard_of = malloc((size_t)n * sizeof(int));
+    int* origins = malloc((size_t)n * sizeof(int));
+    Student* grouped = malloc((size_t)n * sizeof(Student));
+    uint64_t* errors = report->error_bitmap != NULL
+        ? malloc(((size_t)n + 63) / 64 * sizeof(uint64_t)) : NULL;
+    if (shard_of == NULL || origins == NULL || grouped == NULL ||
+        (report->error_bitmap != NULL && errors == NULL)) {
+        free(shard_of);
+        free(origins);
+        free(grouped);
+        free(errors);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    for (int i = 0; i < n; i++) {
+        shard_of[i] = shard_for_id(manager, students[i].id);
+        starts[shard_of[i] + 1]++;
+    }
+    for (int s = 0; s < manager->shard_count; s++) {
+        starts[s + 1] += starts[s];
+    }
+    int next[MAX_STUDENT_SHARDS];
+    memcpy(next, starts, (size_t)manager->shard_count * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        int position = next[shard_of[i]]++;
+        grouped[position] = students[i];
+        origins[position] = i;
+    }
+    free(shard_of);
+
+    int result = SUCCESS;
+    for (int s = 0; s < manager->shard_count && result == SUCCESS; s++) {
+        int rows = starts[s + 1] - starts[s];
+        if (rows == 0) {
+            continue;
+        }
+        StudentBatchReport part = {0, 0, 0, errors};
+        result = add_students_batch(manager->shards[s], &grouped[starts[s]], rows, &part);
+        report->added += part.added;
+        report->invalid += part.invalid;
+        report->duplicates += part.duplicates;
+        for (int i = 0; errors != NULL && result == SUCCESS && i < rows; i++) {
+            if (errors[i / 64] & (UINT64_C(1) << (i % 64))) {
+                int row = origins[starts[s] + i];
+                report->error_bitmap[row / 64] |= UINT64_C(1) << (row % 64);
+            }
+        }
+    }
+
+    free(origins);
+    free(grouped);
+    free(errors);
+    return result;
+}
+
+// Statistics functions
+// The average is merged from each shard's running sum and count, read
+// together under that shard's lock so neither can change in between.
+double sharded_calculate_average_gpa(ShardedStudentManager* manager) {
+    double total = 0.0;
+    long long count = 0;
+    for (int i = 0; manager != NULL && i < manager->shard_count; i++) {
+        StudentManager* shard = manager->shards[i];
+        lock_students_shared(shard);
+        total += shard->gpa_sum + shard->gpa_sum_compensation;
+        count += live_student_count(shard);
+        unlock_students_shared(shard);
+    }
+    return count > 0 ? total / (double)count : 0.0;
+}
+
+// Each shard reports its extreme record, or NULL when empty, in one locked call
+double sharded_calculate_highest_gpa(ShardedStudentManager* manager) {
+    double highest = 0.0;
+    int found = 0;
+    for (int i = 0; manager != NULL && i < manager->shard_count; i++) {
+        const Student* student = find_student_with_highest_gpa(manager->shards[i]);
+        if (student != NULL && (!found || student->gpa > highest)) {
+            highest = student->gpa;
+            found = 1;
+        }
+    }
+    return highest;
+}
+
+double sharded_calculate_lowest_gpa(ShardedStudentManager* manager) {
+    double lowest = 0.0;
+    int found = 0;
+    for (int i = 0; manager != NULL && i < manager->shard_count; i++) {
+        const Student* student = find_student_with_lowest_gpa(manager->shards[i]);
+        if (student != NULL && (!found || student->gpa < lowest)) {
+            lowest = student->gpa;
+            found = 1;
+        }
+    }
+    return lowest;
+}
+
+int sharded_count_students_in_gpa_range(ShardedStudentManager* manager, double min_gpa,
+                                        double max_gpa) {
+    int count = 0;
+    for (int i = 0; manager != NULL && i < manager->shard_count; i++) {
+        count += count_students_in_gpa_range(manager->shards[i], min_gpa, max_gpa);
+    }
+    return count;
+}
+
+int sharded_calculate_gpa_histogram(ShardedStudentManager* manager, int buckets, int* counts) {
+    if (manager == NULL || buckets <= 0 || counts == NULL) {
+        DEBUG_PRINT("Invalid parameters for sharded_calculate_gpa_histogram");
+        return ERROR_INVALID_INPUT;
+    }
+
+    int* partial = malloc((size_t)buckets * sizeof(int));
+    if (partial == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memset(counts, 0, (size_t)buckets * sizeof(int));
+    for (int i = 0; i < manager->shard_count; i++) {
+        int result = calculate_gpa_histogram(manager->shards[i], buckets, partial);
+        if (result != SUCCESS) {
+            free(partial);
+            return result;
+        }
+        for (int b = 0; b < buckets; b++) {
+            counts[b] += partial[b];
+        }
+    }
+    free(partial);
+    return SUCCESS;
+}
+
+// The global top K are among the union of each shard's top K, so those
+// lists are merged one shard at a time, keeping the best k of the two
+int sharded_top_k_by_gpa(ShardedStudentManager* manager, int k, Student* out) {
+    if (manager == NULL || k < 0 || (k > 0 && out == NULL)) {
+        DEBUG_PRINT("Invalid parameters for sharded_top_k_by_gpa");
+        return ERROR_INVALID_INPUT;
+    }
+
+    int total = sharded_get_student_count(manager);
+    if (k > total) {
+        k = total;
+    }
+    if (k == 0) {
+        return 0;
+    }
+
+    Student* shard_best = malloc((size_t)k * sizeof(Student));
+    Student* merged = malloc((size_t)k * sizeof(Student));
+    if (shard_best == NULL || merged == NULL) {
+        free(shard_best);
+        free(merged);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int found = 0;
+    for (int s = 0; s < manager->shard_count; s++) {
+        int n = top_k_by_gpa(manager->shards[s], k, shard_best);
+        if (n < 0) {
+            found = n;
+            break;
+        }
+
+        int a = 0, b = 0, m = 0;
+        while (m < k && (a < found || b < n)) {
+            if (b == n || (a < found && ranks_before(&out[a], &shard_best[b]))) {
+                merged[m++] = out[a++];
+            } else {
+                merged[m++] = shard_best[b++];
+            }
+        }
+        memcpy(out, merged, (size_t)m * sizeof(Student));
+        found = m;
+    }
+
+    free(shard_best);
+    free(merged);
+    return found;
+}
@@ -0,0 +1,59 @@
+#ifndef SHARDED_MANAGER_H
+#define SHARDED_MANAGER_H
+
+#include "student_manager.h"
+
+// A roster split into independent StudentManager partitions (shards), each
+// in thread-safe mode with its own lock. A student lives in the shard chosen
+// by a hash of its ID, so operations on one ID touch one shard and
+// producers adding different students rarely wait for each other. The
+// shard hash differs from the ID index's, so each shard's own index stays
+// evenly spread.
+//
+// Statistics merge per-shard partial results (sums and counts, extremes,
+// histograms, top-K lists). Each shard is read under its own lock in turn,
+// so while writers are active a result combines the shards as of slightly
+// different moments; once they are quiescent it is exact.
+typedef struct ShardedStudentManager ShardedStudentManager;
+
+#define MAX_STUDENT_SHARDS 256
+
+// Constructor and destructor
+// capacity_hint covers the whole roster and is divided among the shards.
+ShardedStudentManager* create_sharded_student_manager(int shards, int capacity_hint);
+void destroy_sharded_student_manager(ShardedStudentManager* manager);
+
+// Shard access, e.g. to change the indexes or removal mode of every shard.
+// Shards must stay in thread-safe mode and must only hold the IDs routed
+// to them.
+int get_student_shard_count(const ShardedStudentManager* manager);
+StudentManager* get_student_shard(ShardedStudentManager* manager, int shard);
+int student_shard_for_id(const ShardedStudentManager* manager, int id);
+
+// Student management functions, routed to the owning shard.
+// sharded_find_student returns a per-thread copy (see student_manager.h).
+int sharded_add_student(ShardedStudentManager* manager, int id, const char* name, double gpa);
+int sharded_remove_student(ShardedStudentManager* manager, int id);
+Student* sharded_find_student(ShardedStudentManager* manager, int id);
+int sharded_get_student(ShardedStudentManager* manager, int id, Student* student);
+int sharded_update_student_gpa(ShardedStudentManager* manager, int id, double new_gpa);
+int sharded_get_student_count(ShardedStudentManager* manager);
+
+// Bulk insert: rows are grouped by shard and each group is added with one
+// add_students_batch call. The report is filled as for add_students_batch.
+// If a shard runs out of memory the groups already handed to other shards
+// stay added, and report->added says how many rows that was.
+int sharded_add_students_batch(ShardedStudentManager* manager, const Student* students, int n,
+                               StudentBatchReport* report);
+
+// Statistics functions, merged across shards; same conventions as the
+// single-manager versions
+double sharded_calculate_average_gpa(ShardedStudentManager* manager);
+double sharded_calculate_highest_gpa(ShardedStudentManager* manager);
+double sharded_calculate_lowest_gpa(ShardedStudentManager* manager);
+int sharded_count_students_in_gpa_range(ShardedStudentManager* manager, double min_gpa,
+                                        double max_gpa);
+int sharded_calculate_gpa_histogram(ShardedStudentManager* manager, int buckets, int* counts);
+int sharded_top_k_by_gpa(ShardedStudentManager* manager, int k, Student* out);
+
+#endif // SHARDED_MANAGER_H
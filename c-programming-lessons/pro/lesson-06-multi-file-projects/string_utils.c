@@ -2,26 +2,438 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 #include "string_utils.h"
+#include "mapped_file.h"
 #include "config.h"
 
-// String manipulation functions
-void string_to_upper(char *str) {
-    DEBUG_PRINT("Converting string to uppercase: %s", str);
-    if (str == NULL) return;
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define STRING_UTILS_X86 1
+#include <immintrin.h>
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX2_POPCNT __attribute__((target("avx2,popcnt")))
+#endif
+
+typedef enum {
+    STRING_ISA_SCALAR,
+    STRING_ISA_SSE2,
+    STRING_ISA_AVX2
+} StringIsa;
+
+// A load of the CPU feature word libgcc fills in at program start, cheap
+// enough to repeat on every call
+static StringIsa detect_isa(void) {
+#ifdef STRING_UTILS_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return STRING_ISA_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return STRING_ISA_SSE2;
+    }
+#endif
+    return STRING_ISA_SCALAR;
+}
+
+// Case conversion kernels. Each flips bit 0x20 of the bytes in
+// [first, first + 25], i.e. 'a'..'z' for upper case or 'A'..'Z' for lower.
+// A converted byte leaves that range, so converting a byte twice is
+// harmless, and every version finishes with one overlapping block instead
+// of a byte loop. The portable version converts eight bytes per 64-bit
+// word with string_convert_case_word from the header.
+
+static void convert_case_bytes(char *str, size_t len, unsigned char first) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)str[i];
+        str[i] = (char)(c ^ (((unsigned char)(c - first) < 26) << 5));
+    }
+}
+
+static void convert_case_scalar(char *str, size_t len, unsigned char first) {
+    if (len < 8) {
+        convert_case_bytes(str, len, first);
+        return;
+    }
     
-    for (int i = 0; str[i] != '\0'; i++) {
-        str[i] = toupper(str[i]);
+    for (size_t i = 0;; i += 8) {
+        if (i + 8 > len) {
+            i = len - 8;
+        }
+        uint64_t word;
+        memcpy(&word, str + i, 8);
+        word = string_convert_case_word(word, first);
+        memcpy(str + i, &word, 8);
+        if (i + 8 == len) break;
     }
 }
 
-void string_to_lower(char *str) {
-    DEBUG_PRINT("Converting string to lowercase: %s", str);
-    if (str == NULL) return;
+#ifdef STRING_UTILS_X86
+// Bytes are signed in SSE2 compares, so shift the letter range down to
+// start at -128 and test for "less than -128 + 26"
+TARGET_SSE2 static void convert_case_sse2(char *str, size_t len, unsigned char first) {
+    const __m128i shift = _mm_set1_epi8((char)(0x80 - first));
+    const __m128i limit = _mm_set1_epi8((char)(0x80 + 26));
+    const __m128i flip = _mm_set1_epi8(0x20);
+    if (len < 16) {
+        convert_case_scalar(str, len, first);
+        return;
+    }
     
-    for (int i = 0; str[i] != '\0'; i++) {
-        str[i] = tolower(str[i]);
+    for (size_t i = 0;; i += 16) {
+        if (i + 16 > len) {
+            i = len - 16;
+        }
+        __m128i c = _mm_loadu_si128((const __m128i *)(str + i));
+        __m128i letter = _mm_cmplt_epi8(_mm_add_epi8(c, shift), limit);
+        _mm_storeu_si128((__m128i *)(str + i), _mm_xor_si128(c, _mm_and_si128(letter, flip)));
+        if (i + 16 == len) break;
+    }
+}
+
+TARGET_AVX2 static void convert_case_avx2(char *str, size_t len, unsigned char first) {
+    const __m256i shift = _mm256_set1_epi8((char)(0x80 - first));
+    const __m256i limit = _mm256_set1_epi8((char)(0x80 + 26));
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    if (len < 32) {
+        convert_case_sse2(str, len, first);
+        return;
+    }
+    
+    for (size_t i = 0;; i += 32) {
+        if (i + 32 > len) {
+            i = len - 32;
+        }
+        __m256i c = _mm256_loadu_si256((const __m256i *)(str + i));
+        __m256i letter = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(c, shift));
+        _mm256_storeu_si256((__m256i *)(str + i), _mm256_xor_si256(c, _mm256_and_si256(letter, flip)));
+        if (i + 32 == len) break;
+    }
+}
+#endif
+
+// Strings too short for a vector skip the dispatch
+static void convert_case(char *str, size_t len, unsigned char first) {
+#ifdef STRING_UTILS_X86
+    switch (len < 16 ? STRING_ISA_SCALAR : detect_isa()) {
+        case STRING_ISA_AVX2:
+            convert_case_avx2(str, len, first);
+            return;
+        case STRING_ISA_SSE2:
+            convert_case_sse2(str, len, first);
+            return;
+        default:
+            break;
+    }
+#endif
+    convert_case_scalar(str, len, first);
+}
+
+// Counting kernels. Whitespace is what isspace accepts in the C locale:
+// ' ' and '\t'..'\r'. A word starts at each non-space byte whose previous
+// byte is a space, so per block the starts are ~space & (space << 1), with
+// the block's last space bit carried into the next block's first. The
+// kernels take whether the byte before str was a space (1 at the start
+// of the text) so a caller can count a long text block by block.
+static int is_space_byte(unsigned char c) {
+    return c == ' ' || (unsigned char)(c - '\t') < 5;
+}
+
+static size_t count_words_scalar(const char *str, size_t len, int prev_space) {
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        int space = is_space_byte((unsigned char)str[i]);
+        count += (size_t)(prev_space & !space);
+        prev_space = space;
     }
+    return count;
+}
+
+static size_t count_characters_scalar(const char *str, size_t len, char ch) {
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        count += (size_t)(str[i] == ch);
+    }
+    return count;
+}
+
+#ifdef STRING_UTILS_X86
+// Same signed range trick as the case kernels: '\t'..'\r' shifted down to
+// start at -128 is "less than -128 + 5"
+TARGET_SSE2 static size_t count_words_sse2(const char *str, size_t len, int prev_space) {
+    const __m128i blank = _mm_set1_epi8(' ');
+    const __m128i shift = _mm_set1_epi8((char)(0x80 - '\t'));
+    const __m128i limit = _mm_set1_epi8((char)(0x80 + 5));
+    unsigned int carry = (unsigned int)prev_space;
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(str + i));
+        __m128i space = _mm_or_si128(_mm_cmpeq_epi8(c, blank),
+                                     _mm_cmplt_epi8(_mm_add_epi8(c, shift), limit));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(space);
+        count += (size_t)__builtin_popcount(~mask & ((mask << 1) | carry) & 0xFFFFu);
+        carry = mask >> 15;
+    }
+    return count + count_words_scalar(str + i, len - i, (int)carry);
+}
+
+TARGET_SSE2 static size_t count_characters_sse2(const char *str, size_t len, char ch) {
+    const __m128i target = _mm_set1_epi8(ch);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(str + i));
+        count += (size_t)__builtin_popcount((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(c, target)));
+    }
+    return count + count_characters_scalar(str + i, len - i, ch);
+}
+
+TARGET_AVX2_POPCNT static size_t count_words_avx2(const char *str, size_t len, int prev_space) {
+    const __m256i blank = _mm256_set1_epi8(' ');
+    const __m256i shift = _mm256_set1_epi8((char)(0x80 - '\t'));
+    const __m256i limit = _mm256_set1_epi8((char)(0x80 + 5));
+    uint32_t carry = (uint32_t)prev_space;
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(str + i));
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(c, blank),
+                                        _mm256_cmpgt_epi8(limit, _mm256_add_epi8(c, shift)));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(space);
+        count += (size_t)__builtin_popcount(~mask & ((mask << 1) | carry));
+        carry = mask >> 31;
+    }
+    return count + count_words_sse2(str + i, len - i, (int)carry);
+}
+
+TARGET_AVX2_POPCNT static size_t count_characters_avx2(const char *str, size_t len, char ch) {
+    const __m256i target = _mm256_set1_epi8(ch);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(str + i));
+        count += (size_t)__builtin_popcount((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, target)));
+    }
+    return count + count_characters_sse2(str + i, len - i, ch);
+}
+#endif
+
+static size_t count_words_range(const char *str, size_t len, int prev_space) {
+#ifdef STRING_UTILS_X86
+    switch (len < 16 ? STRING_ISA_SCALAR : detect_isa()) {
+        case STRING_ISA_AVX2:
+            return count_words_avx2(str, len, prev_space);
+        case STRING_ISA_SSE2:
+            return count_words_sse2(str, len, prev_space);
+        default:
+            break;
+    }
+#endif
+    return count_words_scalar(str, len, prev_space);
+}
+
+static size_t count_characters_range(const char *str, size_t len, char ch) {
+#ifdef STRING_UTILS_X86
+    switch (len < 16 ? STRING_ISA_SCALAR : detect_isa()) {
+        case STRING_ISA_AVX2:
+            return count_characters_avx2(str, len, ch);
+        case STRING_ISA_SSE2:
+            return count_characters_sse2(str, len, ch);
+        default:
+            break;
+    }
+#endif
+    return count_characters_scalar(str, len, ch);
+}
+
+// Substring search. A position is a candidate only if both the first and
+// the last byte of the needle match there; comparing those two bytes at 16
+// or 32 positions per step rejects nearly every other position before any
+// memcmp runs. Needles of SEARCH_HORSPOOL_MIN bytes or more go to
+// Boyer-Moore-Horspool on every ISA: their skips grow with the needle,
+// while the filter's candidates each cost a longer compare.
+// All kernels take needle_len >= 2 and haystack_len >= needle_len.
+#define SEARCH_HORSPOOL_MIN 32
+#define SEARCH_SPLIT_MIN 4096
+
+static const char *search_scalar(const char *haystack, size_t haystack_len,
+                                 const char *needle, size_t needle_len) {
+    const char *last_start = haystack + (haystack_len - needle_len);
+    const char *p = haystack;
+    while (p <= last_start) {
+        p = memchr(p, needle[0], (size_t)(last_start - p) + 1);
+        if (p == NULL) return NULL;
+        if (p[needle_len - 1] == needle[needle_len - 1] &&
+            memcmp(p + 1, needle + 1, needle_len - 2) == 0) {
+            return p;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+// Horspool keyed on the last two bytes of the window rather than the last
+// one: a byte pair is far rarer in the needle than a single byte, so most
+// windows shift by needle_len - 1. Pairs are hashed into 256 shifts and a
+// collision can only shorten a shift, never skip a match.
+#define PAIR_HASH(a, b) ((size_t)(((unsigned)(b) - ((unsigned)(a) << 3)) & 0xFFu))
+
+static const char *search_horspool(const char *haystack, size_t haystack_len,
+                                   const char *needle, size_t needle_len) {
+    const unsigned char *pattern = (const unsigned char *)needle;
+    size_t default_shift = needle_len - 1;
+    size_t shift[256];
+    for (size_t h = 0; h < 256; h++) {
+        shift[h] = default_shift;
+    }
+    for (size_t j = 1; j + 1 < needle_len; j++) {
+        shift[PAIR_HASH(pattern[j - 1], pattern[j])] = needle_len - 1 - j;
+    }
+    
+    // The final pair's own shift becomes 0, so the skip loop stops exactly
+    // on the candidates; after a failed compare it moves on by the shift
+    // the pair would otherwise have had
+    size_t last_hash = PAIR_HASH(pattern[needle_len - 2], pattern[needle_len - 1]);
+    size_t last_shift = shift[last_hash];
+    shift[last_hash] = 0;
+    
+    // Each step waits on the load of the shift it takes, so long texts are
+    // searched as two halves whose steps interleave; the halves overlap by
+    // needle_len - 1 bytes and a match in the first half wins
+    const unsigned char *tail = (const unsigned char *)haystack + needle_len - 1;
+    size_t limit = haystack_len - needle_len;
+    size_t i = 0;
+    size_t k_limit = limit;
+    size_t k = k_limit + 1;     // Second half empty unless the text is split
+    const char *later = NULL;
+    if (limit >= SEARCH_SPLIT_MIN) {
+        k = limit / 2 + 1;
+        limit = k - 1;
+        while (i <= limit && k <= k_limit) {
+            size_t skip_i = shift[PAIR_HASH(tail[i - 1], tail[i])];
+            size_t skip_k = shift[PAIR_HASH(tail[k - 1], tail[k])];
+            if (skip_i != 0 && skip_k != 0) {
+                i += skip_i;
+                k += skip_k;
+                continue;
+            }
+            if (skip_i == 0) {
+                if (memcmp(haystack + i, needle, needle_len) == 0) {
+                    return haystack + i;
+                }
+                skip_i = last_shift;
+            }
+            if (skip_k == 0) {
+                if (memcmp(haystack + k, needle, needle_len) == 0) {
+                    later = haystack + k;
+                    k = k_limit + 1;
+                }
+                skip_k = last_shift;
+            }
+            i += skip_i;
+            k += skip_k;
+        }
+    }
+    
+    while (i <= limit) {
+        size_t skip = shift[PAIR_HASH(tail[i - 1], tail[i])];
+        if (skip != 0) {
+            i += skip;
+            continue;
+        }
+        if (memcmp(haystack + i, needle, needle_len) == 0) {
+            return haystack + i;
+        }
+        i += last_shift;
+    }
+    while (later == NULL && k <= k_limit) {
+        size_t skip = shift[PAIR_HASH(tail[k - 1], tail[k])];
+        if (skip != 0) {
+            k += skip;
+            continue;
+        }
+        if (memcmp(haystack + k, needle, needle_len) == 0) {
+            return haystack + k;
+        }
+        k += last_shift;
+    }
+    return later;
+}
+
+#ifdef STRING_UTILS_X86
+TARGET_SSE2 static const char *search_sse2(const char *haystack, size_t haystack_len,
+                                           const char *needle, size_t needle_len) {
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    size_t i = 0;
+    for (; i + needle_len + 15 <= haystack_len; i += 16) {
+        __m128i head = _mm_loadu_si128((const __m128i *)(haystack + i));
+        __m128i tail = _mm_loadu_si128((const __m128i *)(haystack + i + needle_len - 1));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last)));
+        while (mask != 0) {
+            size_t at = i + (size_t)__builtin_ctz(mask);
+            if (memcmp(haystack + at + 1, needle + 1, needle_len - 2) == 0) {
+                return haystack + at;
+            }
+            mask &= mask - 1;
+        }
+    }
+    if (i + needle_len > haystack_len) return NULL;
+    return search_scalar(haystack + i, haystack_len - i, needle, needle_len);
+}
+
+TARGET_AVX2 static const char *search_avx2(const char *haystack, size_t haystack_len,
+                                           const char *needle, size_t needle_len) {
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    size_t i = 0;
+    for (; i + needle_len + 31 <= haystack_len; i += 32) {
+        __m256i head = _mm256_loadu_si256((const __m256i *)(haystack + i));
+        __m256i tail = _mm256_loadu_si256((const __m256i *)(haystack + i + needle_len - 1));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(head, first), _mm256_cmpeq_epi8(tail, last)));
+        while (mask != 0) {
+            size_t at = i + (size_t)__builtin_ctz(mask);
+            if (memcmp(haystack + at + 1, needle + 1, needle_len - 2) == 0) {
+                return haystack + at;
+            }
+            mask &= mask - 1;
+        }
+    }
+    if (i + needle_len > haystack_len) return NULL;
+    return search_sse2(haystack + i, haystack_len - i, needle, needle_len);
+}
+#endif
+
+const char* string_find_n(const char *str, size_t len, const char *substr, size_t substr_len) {
+    if (str == NULL || substr == NULL || substr_len > len) return NULL;
+    if (substr_len == 0) return str;
+    if (substr_len == 1) return memchr(str, substr[0], len);
+    if (substr_len >= SEARCH_HORSPOOL_MIN) {
+        return search_horspool(str, len, substr, substr_len);
+    }
+    
+#ifdef STRING_UTILS_X86
+    switch (len < substr_len + 15 ? STRING_ISA_SCALAR : detect_isa()) {
+        case STRING_ISA_AVX2:
+            return search_avx2(str, len, substr, substr_len);
+        case STRING_ISA_SSE2:
+            return search_sse2(str, len, substr, substr_len);
+        default:
+            break;
+    }
+#endif
+    return search_scalar(str, len, substr, substr_len);
+}
+
+// String manipulation functions
+// string_to_upper and friends are inline in string_utils.h and only call
+// this once a string is longer than STRING_CASE_INLINE_BYTES
+void string_convert_case_n(char *str, size_t len, char first) {
+    if (str == NULL) return;
+    
+    convert_case(str, len, (unsigned char)first);
 }
 
 void string_reverse(char *str) {
@@ -102,19 +514,7 @@ int count_words(const char *str) {
     DEBUG_PRINT("Counting words in: %s", str);
     if (str == NULL) return 0;
     
-    int count = 0;
-    int in_word = 0;
-    
-    while (*str) {
-        if (isspace(*str)) {
-            in_word = 0;
-        } else if (!in_word) {
-            in_word = 1;
-            count++;
-        }
-        str++;
-    }
-    
+    int count = (int)count_words_range(str, strlen(str), 1);
     DEBUG_PRINT("Word count: %d", count);
     return count;
 }
@@ -123,23 +523,63 @@ int count_characters(const char *str, char ch) {
     DEBUG_PRINT("Counting character '%c' in: %s", ch, str);
     if (str == NULL) return 0;
     
-    int count = 0;
-    while (*str) {
-        if (*str == ch) {
-            count++;
+    int count = (int)count_characters_range(str, strlen(str), ch);
+    DEBUG_PRINT("Character count: %d", count);
+    return count;
+}
+
+size_t count_words_n(const char *str, size_t len) {
+    if (str == NULL) return 0;
+    
+    return count_words_range(str, len, 1);
+}
+
+size_t count_characters_n(const char *str, size_t len, char ch) {
+    if (str == NULL) return 0;
+    
+    return count_characters_range(str, len, ch);
+}
+
+// Blocks small enough to stay in L2 between the word pass and the
+// character pass, so the file is streamed from memory only once
+#define COUNT_FILE_BLOCK (256u * 1024u)
+
+int count_file_text(const char *path, char ch, size_t *words, size_t *characters) {
+    DEBUG_PRINT("Counting words and '%c' in file: %s", ch, path);
+    if (path == NULL) return ERROR_INVALID_INPUT;
+    
+    MappedFile file;
+    int status = map_file_readonly(path, &file);
+    if (status != SUCCESS) {
+        return status;
+    }
+    
+    const char *data = file.data;
+    size_t word_count = 0;
+    size_t character_count = 0;
+    int prev_space = 1;
+    for (size_t offset = 0; offset < file.size; offset += COUNT_FILE_BLOCK) {
+        size_t block = file.size - offset < COUNT_FILE_BLOCK ? file.size - offset : COUNT_FILE_BLOCK;
+        if (words != NULL) {
+            word_count += count_words_range(data + offset, block, prev_space);
+            prev_space = is_space_byte((unsigned char)data[offset + block - 1]);
+        }
+        if (characters != NULL) {
+            character_count += count_characters_range(data + offset, block, ch);
         }
-        str++;
     }
+    unmap_file(&file);
     
-    DEBUG_PRINT("Character count: %d", count);
-    return count;
+    if (words != NULL) *words = word_count;
+    if (characters != NULL) *characters = character_count;
+    return SUCCESS;
 }
 
 int string_contains(const char *str, const char *substr) {
     DEBUG_PRINT("Checking if '%s' contains '%s'", str, substr);
     if (str == NULL || substr == NULL) return 0;
     
-    return strstr(str, substr) != NULL;
+    return string_find_n(str, strlen(str), substr, strlen(substr)) != NULL;
 }
 
 int string_starts_with(const char *str, const char *prefix) {
@@ -199,6 +639,8 @@ int string_compare_ignore_case(const char *str1, const char *str2) {
     return tolower(*str1) - tolower(*str2);
 }
 
+// Single pass: each match is found once and the output grows as needed,
+// instead of counting matches first and searching the input again to copy
 char* string_replace(const char *str, const char *old_substr, const char *new_substr) {
     DEBUG_PRINT("Replacing '%s' with '%s' in '%s'", old_substr, new_substr, str);
     if (str == NULL || old_substr == NULL || new_substr == NULL) return NULL;
@@ -207,46 +649,59 @@ char* string_replace(const char *str, const char *old_substr, const char *new_su
     size_t new_len = strlen(new_substr);
     size_t str_len = strlen(str);
     
-    // Count occurrences
-    int count = 0;
-    const char *temp = str;
-    while ((temp = strstr(temp, old_substr)) != NULL) {
-        count++;
-        temp += old_len;
-    }
-    
-    if (count == 0) {
+    // An empty pattern would match everywhere without advancing
+    if (old_len == 0) {
         return string_duplicate(str);
     }
     
-    // Calculate new string length
-    size_t new_str_len = str_len + count * (new_len - old_len);
-    char *result = malloc(new_str_len + 1);
+    size_t capacity = str_len + 1;
+    size_t size = 0;
+    char *result = malloc(capacity);
     if (result == NULL) {
         DEBUG_PRINT("Memory allocation failed for string replacement");
         return NULL;
     }
     
-    // Perform replacement
-    char *dest = result;
     const char *src = str;
-    
-    while ((temp = strstr(src, old_substr)) != NULL) {
-        // Copy part before match
-        size_t prefix_len = temp - src;
-        strncpy(dest, src, prefix_len);
-        dest += prefix_len;
+    const char *end = str + str_len;
+    const char *match;
+    while ((match = string_find_n(src, (size_t)(end - src), old_substr, old_len)) != NULL) {
+        size_t prefix_len = (size_t)(match - src);
         
-        // Copy replacement
-        strcpy(dest, new_substr);
-        dest += new_len;
+        // Room for this piece and the rest of the input, which can only
+        // shrink from here if replacements are not longer than the pattern
+        size_t required = size + prefix_len + new_len + (size_t)(end - match) - old_len + 1;
+        if (required > capacity) {
+            while (capacity < required) {
+                capacity *= 2;
+            }
+            char *grown = realloc(result, capacity);
+            if (grown == NULL) {
+                DEBUG_PRINT("Memory allocation failed for string replacement");
+                free(result);
+                return NULL;
+            }
+            result = grown;
+        }
         
-        // Move source pointer
-        src = temp + old_len;
+        memcpy(result + size, src, prefix_len);
+        size += prefix_len;
+        memcpy(result + size, new_substr, new_len);
+        size += new_len;
+        src = match + old_len;
     }
     
-    // Copy remaining part
-    strcpy(dest, src);
+    // Copy remaining part, terminator included; capacity always covers it
+    memcpy(result + size, src, (size_t)(end - src) + 1);
+    size += (size_t)(end - src);
+    
+    // Give back what geometric growth over-reserved
+    if (size + 1 < capacity) {
+        char *trimmed = realloc(result, size + 1);
+        if (trimmed != NULL) {
+            result = trimmed;
+        }
+    }
     
     return result;
 }
@@ -2,10 +2,74 @@
 #define STRING_UTILS_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 // String manipulation functions
-void string_to_upper(char *str);
-void string_to_lower(char *str);
+// Case conversion changes ASCII letters only, as toupper/tolower do in the
+// C locale. Strings of up to STRING_CASE_INLINE_BYTES bytes, which covers
+// typical names, are converted inline in the caller with one or two 64-bit
+// words; longer ones go 16 or 32 bytes at a time with SSE2/AVX2 when the
+// CPU has them. The _n variants convert exactly len bytes, NULs included,
+// so callers that know the length skip the strlen.
+#define STRING_CASE_INLINE_BYTES 16
+
+// Out-of-line kernels behind the inline functions below; first is 'a' to
+// convert to upper case and 'A' to convert to lower case
+void string_convert_case_n(char *str, size_t len, char first);
+
+// Flips bit 0x20 of the bytes of word in [first, first + 25]. Adding
+// 0x80 - first sets a byte's top bit once it reaches first, adding
+// 0x80 - (first + 26) once it passes the range, and the low seven bits
+// never carry into the next byte. A converted byte leaves the range, so
+// converting a byte twice is harmless.
+static inline uint64_t string_convert_case_word(uint64_t word, unsigned char first) {
+    const uint64_t bytes_01 = UINT64_C(0x0101010101010101);
+    const uint64_t bytes_80 = UINT64_C(0x8080808080808080);
+    uint64_t low = word & ~bytes_80;
+    uint64_t from_first = low + bytes_01 * (uint64_t)(0x80 - first);
+    uint64_t past_last = low + bytes_01 * (uint64_t)(0x80 - first - 26);
+    uint64_t letters = (from_first ^ past_last) & ~word & bytes_80;
+    return word ^ (letters >> 2);
+}
+
+static inline void string_convert_case_n_inline(char *str, size_t len, char first) {
+    if (str == NULL) return;
+    if (len > STRING_CASE_INLINE_BYTES) {
+        string_convert_case_n(str, len, first);
+    } else if (len >= 8) {
+        // Two words, overlapping unless len is 16
+        uint64_t head, tail;
+        memcpy(&head, str, 8);
+        memcpy(&tail, str + len - 8, 8);
+        head = string_convert_case_word(head, (unsigned char)first);
+        tail = string_convert_case_word(tail, (unsigned char)first);
+        memcpy(str, &head, 8);
+        memcpy(str + len - 8, &tail, 8);
+    } else {
+        for (size_t i = 0; i < len; i++) {
+            unsigned char c = (unsigned char)str[i];
+            str[i] = (char)(c ^ (((unsigned char)(c - (unsigned char)first) < 26) << 5));
+        }
+    }
+}
+
+static inline void string_to_upper(char *str) {
+    if (str != NULL) string_convert_case_n_inline(str, strlen(str), 'a');
+}
+
+static inline void string_to_lower(char *str) {
+    if (str != NULL) string_convert_case_n_inline(str, strlen(str), 'A');
+}
+
+static inline void string_to_upper_n(char *str, size_t len) {
+    string_convert_case_n_inline(str, len, 'a');
+}
+
+static inline void string_to_lower_n(char *str, size_t len) {
+    string_convert_case_n_inline(str, len, 'A');
+}
+
 void string_reverse(char *str);
 size_t string_length(const char *str);
 char* string_duplicate(const char *str);
@@ -14,7 +78,18 @@ char* string_trim(const char *str);
 // String analysis functions
 int count_words(const char *str);
 int count_characters(const char *str, char ch);
+// Whitespace follows isspace in the C locale. Both run 16 or 32 bytes at
+// a time with SSE2/AVX2, popcounting compare masks. The _n variants take
+// any buffer of len bytes, NULs included, and return full-width counts.
+size_t count_words_n(const char *str, size_t len);
+size_t count_characters_n(const char *str, size_t len, char ch);
+// Word and ch counts over a whole file, mapped and scanned in one pass.
+// Either output may be NULL. Returns SUCCESS or an ERROR_* code.
+int count_file_text(const char *path, char ch, size_t *words, size_t *characters);
 int string_contains(const char *str, const char *substr);
+// First occurrence of substr in the len bytes at str, or NULL. Neither
+// needs a terminator, and an empty substr matches at str.
+const char* string_find_n(const char *str, size_t len, const char *substr, size_t substr_len);
 int string_starts_with(const char *str, const char *prefix);
 int string_ends_with(const char *str, const char *suffix);
 
@@ -22,6 +97,8 @@ int string_ends_with(const char *str, const char *suffix);
 void string_concat(const char *str1, const char *str2, char *result, size_t result_size);
 int string_compare_ignore_case(const char *str1, const char *str2);
 char* string_replace(const char *str, const char *old_substr, const char *new_substr);
+// Skips empty tokens, drops tokens of 100+ characters and needs results
+// large enough for every token; StrSplitter in string_view.h has no limits.
 void string_split(const char *str, char delimiter, char results[][100], int *count);
 
 // String validation
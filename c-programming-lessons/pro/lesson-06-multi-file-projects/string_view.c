@@ -0,0 +1,179 @@
+#include "string_view.h"
+#include "string_utils.h"
+#include "student_loader.h"
+
+static int is_space(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static unsigned char fold_case(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c | 0x20) : c;
+}
+
+// Trimming
+StrView strview_trim_left(StrView view) {
+    while (view.length > 0 && is_space((unsigned char)view.data[0])) {
+        view.data++;
+        view.length--;
+    }
+    return view;
+}
+
+StrView strview_trim_right(StrView view) {
+    while (view.length > 0 && is_space((unsigned char)view.data[view.length - 1])) {
+        view.length--;
+    }
+    return view;
+}
+
+StrView strview_trim(StrView view) {
+    return strview_trim_right(strview_trim_left(view));
+}
+
+// Comparison
+int strview_equals(StrView a, StrView b) {
+    return a.length == b.length && (a.length == 0 || memcmp(a.data, b.data, a.length) == 0);
+}
+
+int strview_starts_with(StrView view, StrView prefix) {
+    return prefix.length <= view.length &&
+           (prefix.length == 0 || memcmp(view.data, prefix.data, prefix.length) == 0);
+}
+
+int strview_ends_with(StrView view, StrView suffix) {
+    return suffix.length <= view.length &&
+           (suffix.length == 0 ||
+            memcmp(view.data + view.length - suffix.length, suffix.data, suffix.length) == 0);
+}
+
+int strview_contains(StrView view, StrView needle) {
+    if (needle.length == 0) return 1;
+    return string_find_n(view.data, view.length, needle.data, needle.length) != NULL;
+}
+
+int strview_compare_ignore_case(StrView a, StrView b) {
+    size_t common = a.length < b.length ? a.length : b.length;
+    for (size_t i = 0; i < common; i++) {
+        int c1 = fold_case((unsigned char)a.data[i]);
+        int c2 = fold_case((unsigned char)b.data[i]);
+        if (c1 != c2) {
+            return c1 - c2;
+        }
+    }
+    return (a.length > b.length) - (a.length < b.length);
+}
+
+// Splitting
+int strview_split_next(StrView* rest, char delimiter, StrView* token) {
+    if (rest->data == NULL) return 0;
+
+    const char* found = rest->length ? memchr(rest->data, delimiter, rest->length) : NULL;
+    if (found == NULL) {
+        // Last field: mark the input consumed
+        *token = *rest;
+        *rest = strview_make(NULL, 0);
+        return 1;
+    }
+
+    size_t field_length = (size_t)(found - rest->data);
+    *token = strview_make(rest->data, field_length);
+    rest->data = found + 1;
+    rest->length -= field_length + 1;
+    return 1;
+}
+
+void strview_splitter_init(StrSplitter* splitter, StrView text, StrView delimiter, char quote) {
+    splitter->rest = text;
+    splitter->delimiter = delimiter;
+    splitter->quote = quote;
+    splitter->done = text.data == NULL;
+}
+
+static const char* find_delimiter(const char* from, const char* end, StrView delimiter) {
+    if (delimiter.length == 1) {
+        return memchr(from, delimiter.data[0], (size_t)(end - from));
+    }
+    return string_find_n(from, (size_t)(end - from), delimiter.data, delimiter.length);
+}
+
+int strview_splitter_next(StrSplitter* splitter, StrView* token) {
+    if (splitter->done) return 0;
+
+    const char* start = splitter->rest.data;
+    const char* end = start + splitter->rest.length;
+    if (splitter->delimiter.length == 0) {
+        *token = splitter->rest;
+        splitter->done = 1;
+        return 1;
+    }
+
+    // A delimiter only counts if no quote opens before it; each quoted
+    // span is skipped whole. The delimiter is searched for again only when
+    // a span covers it, so every byte is scanned a bounded number of times.
+    const char* scan = start;
+    const char* found = find_delimiter(scan, end, splitter->delimiter);
+    while (splitter->quote != '\0') {
+        const char* limit = found ? found : end;
+        const char* open = memchr(scan, splitter->quote, (size_t)(limit - scan));
+        if (open == NULL) break;
+
+        const char* close = memchr(open + 1, splitter->quote, (size_t)(end - open - 1));
+        if (close == NULL) {
+            found = NULL;
+            break;
+        }
+        scan = close + 1;
+        if (found != NULL && found < scan) {
+            found = find_delimiter(scan, end, splitter->delimiter);
+        }
+    }
+
+    const char* field_end = found ? found : end;
+    *token = strview_make(start, (size_t)(field_end - start));
+    if (splitter->quote != '\0' && token->length >= 2 &&
+        token->data[0] == splitter->quote && token->data[token->length - 1] == splitter->quote) {
+        token->data++;
+        token->length -= 2;
+    }
+
+    if (found == NULL) {
+        splitter->done = 1;
+    } else {
+        const char* next = found + splitter->delimiter.length;
+        splitter->rest = strview_make(next, (size_t)(end - next));
+    }
+    return 1;
+}
+
+// Numeric parsing
+// The loader's field parsers already work on unterminated ranges; the
+// views only add the rule that nothing but whitespace may follow.
+int strview_parse_int(StrView view, int* value) {
+    view = strview_trim(view);
+    if (view.length == 0) return 0;
+
+    const char* cursor = view.data;
+    const char* end = view.data + view.length;
+    int parsed;
+    if (!parse_int_field(&cursor, end, &parsed) || cursor != end) {
+        return 0;
+    }
+
+    *value = parsed;
+    return 1;
+}
+
+int strview_parse_double(StrView view, double* value) {
+    view = strview_trim(view);
+    if (view.length == 0) return 0;
+
+    const char* cursor = view.data;
+    const char* end = view.data + view.length;
+    double parsed;
+    if (!parse_double_field(&cursor, end, &parsed) || cursor != end) {
+        return 0;
+    }
+
+    *value = parsed;
+    return 1;
+}
@@ -0,0 +1,74 @@
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include <stddef.h>
+#include <string.h>
+
+// Non-owning view of length bytes at data. Nothing here allocates or
+// writes: trimming and splitting return narrower views into the same
+// bytes, so a view is valid only as long as the text it points into.
+// The bytes need no terminator and may contain NULs. Classification and
+// case folding are ASCII, as in the C locale.
+typedef struct {
+    const char* data;
+    size_t length;
+} StrView;
+
+static inline StrView strview_make(const char* data, size_t length) {
+    StrView view = { data, length };
+    return view;
+}
+
+// NULL gives an empty view with NULL data
+static inline StrView strview_from_cstr(const char* str) {
+    return strview_make(str, str ? strlen(str) : 0);
+}
+
+// Trimming
+StrView strview_trim(StrView view);
+StrView strview_trim_left(StrView view);
+StrView strview_trim_right(StrView view);
+
+// Comparison
+int strview_equals(StrView a, StrView b);
+int strview_starts_with(StrView view, StrView prefix);
+int strview_ends_with(StrView view, StrView suffix);
+int strview_contains(StrView view, StrView needle);
+// Sign follows string_compare_ignore_case; a proper prefix sorts first
+int strview_compare_ignore_case(StrView a, StrView b);
+
+// Splitting
+// Takes the field before the next delimiter from *rest into *token and
+// returns 1, leaving *rest after the delimiter; returns 0 once the last
+// field is taken. Empty fields are kept, so "a,,b" yields "a", "" and
+// "b", and an empty view with non-NULL data yields one empty field.
+int strview_split_next(StrView* rest, char delimiter, StrView* token);
+
+// Streaming splitter for delimiters of any length and optionally quoted
+// fields. Tokens are views into the text, so input size and token count
+// are unbounded and nothing is copied. Single-byte delimiters are found
+// with memchr, longer ones with string_find_n.
+//
+// With quote set (0 for none), delimiters between a pair of quote
+// characters do not split, and a field that starts and ends with the
+// quote is yielded without them. Doubled quotes inside stay doubled, as
+// undoing them would need a copy; an unclosed quote runs to the end of
+// the text. Empty fields are kept as with strview_split_next, and an
+// empty delimiter yields the whole text as one field.
+typedef struct {
+    StrView rest;
+    StrView delimiter;
+    char quote;
+    int done;
+} StrSplitter;
+
+void strview_splitter_init(StrSplitter* splitter, StrView text, StrView delimiter, char quote);
+int strview_splitter_next(StrSplitter* splitter, StrView* token);
+
+// Numeric parsing
+// The whole view, less surrounding whitespace, must be the number; on
+// failure *value is left untouched and 0 is returned.
+int strview_parse_int(StrView view, int* value);
+int strview_parse_double(StrView view, double* value);
+
+#endif // STRING_VIEW_H
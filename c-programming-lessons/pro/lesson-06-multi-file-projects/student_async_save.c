@@ -0,0 +1,133 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "student_async_save.h"
+#include "student_manager_internal.h"
+#include "config.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+struct StudentSaveHandle {
+    StudentManager* records;    // Private copy, released once written
+    char* filename;
+    char* temp_name;
+    int result;
+    atomic_int finished;        // Set after result is stored
+#ifndef _WIN32
+    pthread_t thread;
+    int started;
+#endif
+};
+
+static void free_handle(StudentSaveHandle* handle) {
+    destroy_student_manager(handle->records);
+    free(handle->filename);
+    free(handle->temp_name);
+    free(handle);
+}
+
+// Write to a side file and rename so the target is never left torn
+static void write_copy(StudentSaveHandle* handle) {
+    int result = save_students_to_file_locked(handle->records, handle->temp_name);
+    destroy_student_manager(handle->records);
+    handle->records = NULL;
+
+#ifdef _WIN32
+    if (result == SUCCESS) {
+        remove(handle->filename);  // rename() does not replace existing files on Windows
+    }
+#endif
+    if (result == SUCCESS && rename(handle->temp_name, handle->filename) != 0) {
+        result = ERROR_FILE_IO;
+    }
+    if (result != SUCCESS) {
+        DEBUG_PRINT("Background save to %s failed: %d", handle->filename, result);
+        remove(handle->temp_name);
+    }
+
+    handle->result = result;
+    atomic_store(&handle->finished, 1);
+}
+
+#ifndef _WIN32
+static void* save_thread(void* argument) {
+    write_copy(argument);
+    return NULL;
+}
+#endif
+
+StudentSaveHandle* save_students_to_file_async(StudentManager* manager, const char* filename) {
+    DEBUG_PRINT("Starting background save to file: %s", filename);
+
+    if (manager == NULL || filename == NULL) {
+        DEBUG_PRINT("Invalid parameters for save_students_to_file_async");
+        return NULL;
+    }
+
+    StudentSaveHandle* handle = calloc(1, sizeof(StudentSaveHandle));
+    if (handle == NULL) {
+        return NULL;
+    }
+    size_t name_length = strlen(filename);
+    handle->filename = malloc(name_length + 1);
+    handle->temp_name = malloc(name_length + 5);
+    if (handle->filename == NULL || handle->temp_name == NULL) {
+        free_handle(handle);
+        return NULL;
+    }
+    memcpy(handle->filename, filename, name_length + 1);
+    memcpy(handle->temp_name, filename, name_length);
+    memcpy(handle->temp_name + name_length, ".tmp", 5);
+    atomic_init(&handle->finished, 0);
+
+    lock_students_for_scan(manager);
+    handle->records = copy_student_records(manager);
+    unlock_students_shared(manager);
+    if (handle->records == NULL) {
+        DEBUG_PRINT("Not enough memory to copy the roster for saving");
+        free_handle(handle);
+        return NULL;
+    }
+
+#ifndef _WIN32
+    handle->started = pthread_create(&handle->thread, NULL, save_thread, handle) == 0;
+    if (!handle->started) {
+        write_copy(handle);
+    }
+#else
+    write_copy(handle);
+#endif
+    return handle;
+}
+
+int poll_student_save(StudentSaveHandle* handle, int* result) {
+    if (handle == NULL || !atomic_load(&handle->finished)) {
+        return 0;
+    }
+    if (result != NULL) {
+        *result = handle->result;
+    }
+    return 1;
+}
+
+int wait_student_save(StudentSaveHandle* handle) {
+    if (handle == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+
+#ifndef _WIN32
+    if (handle->started) {
+        pthread_join(handle->thread, NULL);
+    }
+#endif
+    int result = handle->result;
+    free_handle(handle);
+    return result;
+}
@@ -0,0 +1,26 @@
+#ifndef STUDENT_ASYNC_SAVE_H
+#define STUDENT_ASYNC_SAVE_H
+
+#include "student_manager.h"
+
+// Background text saves in the save_students_to_file format. Starting one
+// copies the records under the read lock with a few bulk copies, so writers
+// wait for that copy only, never for the formatting or the disk. A
+// background thread then writes the copy to "<filename>.tmp" and renames it
+// over filename, so readers of filename see either the previous file or the
+// complete new one. Where threads are unavailable the save runs before
+// save_students_to_file_async returns.
+typedef struct StudentSaveHandle StudentSaveHandle;
+
+// Returns NULL if the copy or the handle could not be allocated
+StudentSaveHandle* save_students_to_file_async(StudentManager* manager, const char* filename);
+
+// Returns 1 and stores the save's result code in *result (optional) once the
+// file is written, 0 while the save is still in flight
+int poll_student_save(StudentSaveHandle* handle, int* result);
+
+// Blocks until the file is written, frees the handle and returns the save's
+// result code. Every handle must be waited on exactly once.
+int wait_student_save(StudentSaveHandle* handle);
+
+#endif // STUDENT_ASYNC_SAVE_H
@@ -0,0 +1,408 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "student_journal.h"
+#include "student_manager_internal.h"
+#include "mapped_file.h"
+#include "config.h"
+
+#define JOURNAL_MIN_CHECKPOINT_RECORDS 4096
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+_Static_assert(sizeof(StudentJournalHeader) == 16, "journal header must stay 16 bytes");
+_Static_assert(sizeof(StudentJournalRecord) == 32, "journal records must stay 32 bytes");
+
+struct StudentJournal {
+    FILE* file;
+    char* snapshot_path;
+    char* journal_path;
+    uint64_t sequence;      // Last sequence number handed out
+    uint64_t records;       // Records appended since the last checkpoint
+    int pending;            // Records not yet flushed
+    int error;              // First append failure since the last checkpoint
+};
+
+static uint32_t fnv1a(uint32_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t record_checksum(const StudentJournalRecord* record, const char* name) {
+    StudentJournalRecord copy = *record;
+    copy.checksum = 0;
+    return fnv1a(fnv1a(FNV_OFFSET_BASIS, &copy, sizeof(copy)), name, record->name_length);
+}
+
+static char* copy_path(const char* path) {
+    size_t size = strlen(path) + 1;
+    char* copy = malloc(size);
+    if (copy != NULL) {
+        memcpy(copy, path, size);
+    }
+    return copy;
+}
+
+static void free_journal(StudentJournal* journal) {
+    if (journal->file != NULL) {
+        fclose(journal->file);
+    }
+    free(journal->snapshot_path);
+    free(journal->journal_path);
+    free(journal);
+}
+
+// Record appends. Failures are sticky: once a record is lost, later ones
+// would replay onto the wrong state, so nothing more is written until a
+// checkpoint has captured the whole roster again.
+static void append_record(StudentJournal* journal, StudentJournalOperation operation,
+                          int id, const char* name, double gpa) {
+    if (journal->error != SUCCESS) {
+        return;
+    }
+
+    StudentJournalRecord record;
+    memset(&record, 0, sizeof(record));
+    record.sequence = ++journal->sequence;
+    record.gpa = gpa;
+    record.id = id;
+    record.operation = (uint8_t)operation;
+    record.name_length = (uint8_t)(name != NULL ? strlen(name) : 0);
+    record.checksum = record_checksum(&record, name);
+
+    if (fwrite(&record, sizeof(record), 1, journal->file) != 1 ||
+        (record.name_length > 0 &&
+         fwrite(name, 1, record.name_length, journal->file) != record.name_length)) {
+        DEBUG_PRINT("Failed to append journal record %llu", (unsigned long long)record.sequence);
+        journal->error = ERROR_FILE_IO;
+        return;
+    }
+    journal->records++;
+    journal->pending++;
+}
+
+void journal_log_students(StudentManager* manager, int first_slot, int n) {
+    if (manager->journal == NULL) {
+        return;
+    }
+    for (int slot = first_slot; slot < first_slot + n; slot++) {
+        if (student_id_at(manager, slot) != 0) {
+            append_record(manager->journal, JOURNAL_ADD, student_id_at(manager, slot),
+                          student_name_at(manager, slot), student_gpa_at(manager, slot));
+        }
+    }
+}
+
+void journal_log_removal(StudentManager* manager, int id) {
+    if (manager->journal != NULL) {
+        append_record(manager->journal, JOURNAL_REMOVE, id, NULL, 0.0);
+    }
+}
+
+void journal_log_gpa(StudentManager* manager, int id, double gpa) {
+    if (manager->journal != NULL) {
+        append_record(manager->journal, JOURNAL_UPDATE_GPA, id, NULL, gpa);
+    }
+}
+
+void journal_log_clear(StudentManager* manager) {
+    if (manager->journal != NULL) {
+        append_record(manager->journal, JOURNAL_CLEAR, 0, NULL, 0.0);
+    }
+}
+
+uint64_t journal_sequence(const StudentManager* manager) {
+    return manager->journal != NULL ? manager->journal->sequence : 0;
+}
+
+// Start an empty journal, replacing whatever was at its path
+static int start_journal_file(StudentJournal* journal) {
+    if (journal->file != NULL) {
+        fclose(journal->file);
+    }
+
+    journal->file = fopen(journal->journal_path, "wb");
+    if (journal->file == NULL) {
+        DEBUG_PRINT("Failed to create journal: %s", journal->journal_path);
+        return ERROR_FILE_IO;
+    }
+
+    StudentJournalHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = JOURNAL_VERSION;
+    header.record_size = sizeof(StudentJournalRecord);
+    if (fwrite(&header, sizeof(header), 1, journal->file) != 1 || fflush(journal->file) != 0) {
+        return ERROR_FILE_IO;
+    }
+    return SUCCESS;
+}
+
+// Snapshot first, then truncate the journal: a crash in between leaves a
+// journal whose records the snapshot's sequence stamp already covers. The
+// snapshot is synced before it is renamed into place, so the truncation
+// cannot reach the disk ahead of it.
+static int checkpoint_locked(StudentManager* manager) {
+    StudentJournal* journal = manager->journal;
+    DEBUG_PRINT("Checkpointing journal at sequence %llu", (unsigned long long)journal->sequence);
+
+    // Snapshots hold live records only; removed slots would read back as
+    // corrupt records with ID 0
+    purge_tombstones(manager);
+    int result = save_students_snapshot_locked(manager, journal->snapshot_path);
+    if (result == SUCCESS) {
+        result = start_journal_file(journal);
+    }
+    if (result == SUCCESS) {
+        journal->records = 0;
+        journal->pending = 0;
+    }
+    journal->error = result;
+    return result;
+}
+
+void journal_commit(StudentManager* manager) {
+    StudentJournal* journal = manager->journal;
+    if (journal == NULL || journal->pending == 0) {
+        return;
+    }
+
+    journal->pending = 0;
+    if (journal->error == SUCCESS && fflush(journal->file) != 0) {
+        journal->error = ERROR_FILE_IO;
+    }
+
+    // Replay never has to do more than a snapshot load's worth of work, and
+    // each checkpoint is paid for by at least as many appended records
+    int live = live_student_count(manager);
+    if (journal->records >= JOURNAL_MIN_CHECKPOINT_RECORDS && journal->records > (uint64_t)live) {
+        checkpoint_locked(manager);
+    }
+}
+
+void journal_free(StudentManager* manager) {
+    if (manager->journal != NULL) {
+        free_journal(manager->journal);
+        manager->journal = NULL;
+    }
+}
+
+static int apply_record(StudentManager* manager, const StudentJournalRecord* record, const char* name) {
+    char buffer[MAX_NAME_LENGTH];
+    int result = SUCCESS;
+
+    switch (record->operation) {
+        case JOURNAL_ADD:
+            memcpy(buffer, name, record->name_length);
+            buffer[record->name_length] = '\0';
+            result = add_student_locked(manager, record->id, buffer, record->gpa);
+            break;
+        case JOURNAL_REMOVE:
+            result = remove_student_locked(manager, record->id);
+            break;
+        case JOURNAL_UPDATE_GPA:
+            result = update_student_gpa_locked(manager, record->id, record->gpa);
+            break;
+        default:
+            clear_all_students_locked(manager);
+            break;
+    }
+
+    // Only successful operations are journaled, so anything but running out
+    // of memory means the journal does not belong to this snapshot
+    if (result != SUCCESS && result != ERROR_MEMORY_ALLOCATION) {
+        DEBUG_PRINT("Journal record %llu does not apply", (unsigned long long)record->sequence);
+        result = ERROR_FILE_CORRUPT;
+    }
+    return result;
+}
+
+// Apply the intact prefix of the journal on top of the loaded snapshot,
+// or on top of an empty roster if there was none. *torn is set when the
+// file ends in a partial or damaged record.
+static int replay_journal(StudentManager* manager, StudentJournal* journal, int have_snapshot,
+                          int* torn) {
+    MappedFile file;
+    int result = map_file_readonly(journal->journal_path, &file);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    *torn = 0;
+    if (!have_snapshot) {
+        clear_all_students_locked(manager);
+    }
+
+    StudentJournalHeader header;
+    if (file.size < sizeof(header)) {
+        unmap_file(&file);
+        *torn = 1;  // Crashed while creating it
+        return SUCCESS;
+    }
+    memcpy(&header, file.data, sizeof(header));
+    if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != JOURNAL_VERSION || header.record_size != sizeof(StudentJournalRecord)) {
+        DEBUG_PRINT("Unsupported journal: %s", journal->journal_path);
+        unmap_file(&file);
+        return ERROR_FILE_CORRUPT;
+    }
+
+    const char* p = (const char*)file.data + sizeof(header);
+    const char* end = (const char*)file.data + file.size;
+    uint64_t last = 0;
+    uint64_t applied = 0;
+
+    while (p < end && result == SUCCESS) {
+        StudentJournalRecord record;
+        if ((size_t)(end - p) < sizeof(record)) {
+            *torn = 1;
+            break;
+        }
+        memcpy(&record, p, sizeof(record));
+        const char* name = p + sizeof(record);
+
+        if (record.name_length >= MAX_NAME_LENGTH ||
+            (size_t)(end - name) < record.name_length ||
+            record.operation < JOURNAL_ADD || record.operation > JOURNAL_CLEAR ||
+            record.sequence <= last ||
+            record_checksum(&record, name) != record.checksum) {
+            *torn = 1;
+            break;
+        }
+
+        // Records up to the snapshot's stamp are already part of it; a gap
+        // after it means the snapshot is older than the journal expects
+        if (record.sequence > journal->sequence + 1) {
+            DEBUG_PRINT("Journal resumes at %llu after snapshot stamp %llu",
+                        (unsigned long long)record.sequence, (unsigned long long)journal->sequence);
+            result = ERROR_FILE_CORRUPT;
+        } else if (record.sequence == journal->sequence + 1) {
+            result = apply_record(manager, &record, name);
+            journal->sequence = record.sequence;
+            applied++;
+        }
+        last = record.sequence;
+        p = name + record.name_length;
+    }
+
+    unmap_file(&file);
+    DEBUG_PRINT("Replayed %llu journal records", (unsigned long long)applied);
+    return result;
+}
+
+// Journal lifecycle
+static int open_journal_locked(StudentManager* manager, const char* snapshot_path,
+                               const char* journal_path) {
+    DEBUG_PRINT("Opening journal %s over snapshot %s", journal_path, snapshot_path);
+
+    if (manager == NULL || snapshot_path == NULL || journal_path == NULL || manager->journal != NULL) {
+        DEBUG_PRINT("Invalid parameters for open_student_journal");
+        return ERROR_INVALID_INPUT;
+    }
+
+    StudentJournal* journal = calloc(1, sizeof(StudentJournal));
+    if (journal == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    journal->snapshot_path = copy_path(snapshot_path);
+    journal->journal_path = copy_path(journal_path);
+    if (journal->snapshot_path == NULL || journal->journal_path == NULL) {
+        free_journal(journal);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    int result = load_students_snapshot_locked(manager, snapshot_path, &journal->sequence);
+    int have_snapshot = result == SUCCESS;
+    if (result == ERROR_FILE_NOT_FOUND) {
+        result = SUCCESS;
+    }
+
+    int torn = 0;
+    int have_journal = 0;
+    if (result == SUCCESS) {
+        result = replay_journal(manager, journal, have_snapshot, &torn);
+        have_journal = result != ERROR_FILE_NOT_FOUND;
+        if (result == ERROR_FILE_NOT_FOUND) {
+            result = SUCCESS;
+        }
+    }
+    if (result != SUCCESS) {
+        if (have_snapshot || have_journal) {
+            clear_all_students_locked(manager);
+        }
+        free_journal(journal);
+        return result;
+    }
+
+    // Keep appending to an intact journal; otherwise capture the current
+    // state in a checkpoint, which also discards a torn tail
+    manager->journal = journal;
+    if (have_journal && !torn) {
+        journal->file = fopen(journal_path, "ab");
+        result = journal->file != NULL ? SUCCESS : ERROR_FILE_IO;
+    } else {
+        result = checkpoint_locked(manager);
+    }
+    if (result != SUCCESS) {
+        journal_free(manager);
+        return result;
+    }
+
+    DEBUG_PRINT("Journal open at sequence %llu with %d students",
+                (unsigned long long)journal->sequence, live_student_count(manager));
+    return SUCCESS;
+}
+
+int open_student_journal(StudentManager* manager, const char* snapshot_path,
+                         const char* journal_path) {
+    lock_students_exclusive(manager);
+    int result = open_journal_locked(manager, snapshot_path, journal_path);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+int checkpoint_student_journal(StudentManager* manager) {
+    lock_students_exclusive(manager);
+    int result = ERROR_INVALID_INPUT;
+    if (manager != NULL && manager->journal != NULL) {
+        result = checkpoint_locked(manager);
+    }
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+// Detach without checkpointing; the files stay valid for the next open
+static int close_journal_locked(StudentManager* manager) {
+    if (manager == NULL || manager->journal == NULL) {
+        DEBUG_PRINT("No journal attached");
+        return ERROR_INVALID_INPUT;
+    }
+
+    journal_commit(manager);
+    int result = manager->journal->error;
+    if (manager->journal->file != NULL && fclose(manager->journal->file) != 0 &&
+        result == SUCCESS) {
+        result = ERROR_FILE_IO;
+    }
+    manager->journal->file = NULL;
+    journal_free(manager);
+    return result;
+}
+
+int close_student_journal(StudentManager* manager) {
+    lock_students_exclusive(manager);
+    int result = close_journal_locked(manager);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+int get_student_journal_status(StudentManager* manager) {
+    lock_students_shared(manager);
+    int result = manager != NULL && manager->journal != NULL ? manager->journal->error
+                                                             : ERROR_INVALID_INPUT;
+    unlock_students_shared(manager);
+    return result;
+}
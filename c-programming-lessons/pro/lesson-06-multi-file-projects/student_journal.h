@@ -0,0 +1,63 @@
+#ifndef STUDENT_JOURNAL_H
+#define STUDENT_JOURNAL_H
+
+#include <stdint.h>
+#include "student_manager.h"
+
+// Write-ahead journal of roster changes (version 1), all integers in host
+// byte order:
+//
+//   StudentJournalHeader                       16 bytes
+//   { StudentJournalRecord, name bytes }*      32 bytes + name_length each
+//
+// Once attached, every successful add, remove, GPA update and clear is
+// appended (and flushed) as the manager's write lock is released, so
+// persisting a change costs one small append instead of a full rewrite.
+// A checkpoint writes a snapshot stamped with the last journal sequence
+// number and then starts an empty journal; replay skips records the
+// snapshot already contains, so a crash in between loses nothing. A
+// checkpoint is taken automatically once the journal holds more records
+// than the roster has students. Replay restores the roster's contents;
+// record order changed by sorting or swap removal since the last
+// checkpoint is not journaled.
+#define JOURNAL_MAGIC "STUDJRNL"
+#define JOURNAL_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+} StudentJournalHeader;
+
+typedef enum {
+    JOURNAL_ADD = 1,        // id, gpa and name
+    JOURNAL_REMOVE,         // id
+    JOURNAL_UPDATE_GPA,     // id and gpa
+    JOURNAL_CLEAR
+} StudentJournalOperation;
+
+typedef struct {
+    uint64_t sequence;      // Strictly increasing across the journal's life
+    double gpa;
+    int32_t id;
+    uint32_t checksum;      // FNV-1a of the record (this field zero) and name
+    uint8_t operation;
+    uint8_t name_length;    // Name bytes that follow, without a terminator
+    uint8_t reserved[6];
+} StudentJournalRecord;
+
+// Journal lifecycle
+// open_student_journal replaces the roster with the snapshot plus the
+// journal replayed on top of it; if neither file exists the current roster
+// becomes the first checkpoint. A torn or corrupt journal tail (e.g. from a
+// crash mid-append) is dropped and a fresh checkpoint is written.
+// Appends only reach the operating system's cache; a failed append is
+// remembered and reported by get_student_journal_status until the next
+// successful checkpoint, which rewrites everything.
+int open_student_journal(StudentManager* manager, const char* snapshot_path,
+                         const char* journal_path);
+int checkpoint_student_journal(StudentManager* manager);
+int close_student_journal(StudentManager* manager);
+int get_student_journal_status(StudentManager* manager);
+
+#endif // STUDENT_JOURNAL_H
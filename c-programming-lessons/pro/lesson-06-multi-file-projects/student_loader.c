@@ -0,0 +1,381 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "student_loader.h"
+#include "student_manager_internal.h"
+#include "mapped_file.h"
+#include "config.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define MIN_CHUNK_BYTES (1 << 20)   // Smaller files are not worth a thread
+#define MAX_LOADER_THREADS 64
+#define MAX_EXACT_MANTISSA (1ull << 53)
+
+// Work item for one newline-aligned slice of the file
+typedef struct {
+    const char* begin;
+    const char* end;
+    Student* rows;          // Successfully parsed rows, in file order
+    int* ordinals;          // Record-line number of each row within the chunk
+    int row_count;
+    int row_capacity;
+    int line_count;         // Non-blank lines seen, parsed or not
+    int failed;             // Set on allocation failure
+} LoadChunk;
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// Field parsers
+int parse_int_field(const char** cursor, const char* end, int* value) {
+    const char* p = *cursor;
+    while (p < end && is_blank(*p)) p++;
+
+    int negative = 0;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    if (p == end || *p < '0' || *p > '9') {
+        return 0;
+    }
+
+    long long result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p - '0');
+        if (result > (long long)INT_MAX + 1) {
+            return 0;
+        }
+        p++;
+    }
+
+    result = negative ? -result : result;
+    if (result > INT_MAX) {
+        return 0;
+    }
+
+    *value = (int)result;
+    *cursor = p;
+    return 1;
+}
+
+int parse_double_field(const char** cursor, const char* end, double* value) {
+    static const double powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* p = *cursor;
+    while (p < end && is_blank(*p)) p++;
+    const char* start = p;
+
+    int negative = 0;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    // Fast path: plain decimal "digits[.digits]". A mantissa below 2^53 and
+    // at most 22 fraction digits are both exact doubles, so one division
+    // yields the correctly rounded result, identical to strtod.
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int fraction_digits = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+        digits++;
+        p++;
+        if (digits > 18) break;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9' && digits <= 18) {
+            mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+            digits++;
+            fraction_digits++;
+            p++;
+        }
+    }
+
+    int simple = digits > 0 && digits <= 18 && fraction_digits <= 22 &&
+                 mantissa < MAX_EXACT_MANTISSA &&
+                 (p == end || !((*p >= '0' && *p <= '9') || *p == 'e' || *p == 'E' ||
+                                *p == 'x' || *p == 'X' || *p == '.'));
+    if (simple) {
+        double result = (double)mantissa / powers_of_ten[fraction_digits];
+        *value = negative ? -result : result;
+        *cursor = p;
+        return 1;
+    }
+
+    // Exponents, long mantissas, hex floats, inf/nan: defer to strtod on a
+    // bounded, NUL-terminated copy since the mapped text has no terminator
+    char buffer[128];
+    size_t length = 0;
+    while (start + length < end && length < sizeof(buffer) - 1 &&
+           start[length] != ',' && start[length] != '\n') {
+        length++;
+    }
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+
+    char* parsed_end;
+    double result = strtod(buffer, &parsed_end);
+    if (parsed_end == buffer) {
+        return 0;
+    }
+
+    *value = result;
+    *cursor = start + (parsed_end - buffer);
+    return 1;
+}
+
+// Parse one "ID,Name,GPA" line using the same rules as the original
+// fscanf("%d,%49[^,],%lf") loader: the name is taken verbatim and must be
+// 1-49 characters; anything after the GPA is ignored.
+static int parse_student_line(const char* line, const char* end, Student* student) {
+    const char* p = line;
+
+    if (!parse_int_field(&p, end, &student->id) || p == end || *p != ',') {
+        return 0;
+    }
+    p++;
+
+    const char* comma = memchr(p, ',', (size_t)(end - p));
+    size_t name_length = comma ? (size_t)(comma - p) : 0;
+    if (comma == NULL || name_length == 0 || name_length >= MAX_NAME_LENGTH) {
+        return 0;
+    }
+    memcpy(student->name, p, name_length);
+    student->name[name_length] = '\0';
+    p = comma + 1;
+
+    return parse_double_field(&p, end, &student->gpa);
+}
+
+static int push_row(LoadChunk* chunk, const Student* student, int ordinal) {
+    if (chunk->row_count == chunk->row_capacity) {
+        int capacity = chunk->row_capacity ? chunk->row_capacity * 2 : 1024;
+        Student* rows = realloc(chunk->rows, (size_t)capacity * sizeof(Student));
+        if (rows == NULL) {
+            return 0;
+        }
+        chunk->rows = rows;
+
+        int* ordinals = realloc(chunk->ordinals, (size_t)capacity * sizeof(int));
+        if (ordinals == NULL) {
+            return 0;
+        }
+        chunk->ordinals = ordinals;
+        chunk->row_capacity = capacity;
+    }
+
+    chunk->rows[chunk->row_count] = *student;
+    chunk->ordinals[chunk->row_count] = ordinal;
+    chunk->row_count++;
+    return 1;
+}
+
+static void parse_chunk(LoadChunk* chunk) {
+    const char* p = chunk->begin;
+
+    while (p < chunk->end) {
+        const char* newline = memchr(p, '\n', (size_t)(chunk->end - p));
+        const char* line_end = newline ? newline : chunk->end;
+
+        // fscanf skipped blank lines while looking for the next record
+        const char* first = p;
+        while (first < line_end && is_blank(*first)) first++;
+
+        if (first < line_end) {
+            Student student;
+            if (parse_student_line(first, line_end, &student)) {
+                if (!push_row(chunk, &student, chunk->line_count)) {
+                    chunk->failed = 1;
+                    return;
+                }
+            } else {
+                DEBUG_PRINT("Failed to parse student data: %.*s",
+                            (int)(line_end - first), first);
+            }
+            chunk->line_count++;
+        }
+
+        p = line_end + 1;
+    }
+}
+
+#ifndef _WIN32
+static void* parse_chunk_thread(void* argument) {
+    parse_chunk(argument);
+    return NULL;
+}
+#endif
+
+static int default_thread_count(void) {
+#if !defined(_WIN32) && defined(_SC_NPROCESSORS_ONLN)
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+#else
+    return 1;
+#endif
+}
+
+// Skip the two comment lines and read the record count, returning the
+// position where record lines begin or NULL if the header is malformed
+static const char* parse_header(const char* data, const char* end, int* count) {
+    const char* p = data;
+    for (int line = 0; line < 2 && p < end; line++) {
+        const char* newline = memchr(p, '\n', (size_t)(end - p));
+        p = newline ? newline + 1 : end;
+    }
+
+    if (!parse_int_field(&p, end, count)) {
+        return NULL;
+    }
+
+    const char* newline = memchr(p, '\n', (size_t)(end - p));
+    return newline ? newline + 1 : end;
+}
+
+static int merge_chunks(StudentManager* manager, LoadChunk* chunks, int chunk_count, int count) {
+    int lines_before = 0;
+
+    for (int c = 0; c < chunk_count && lines_before < count; c++) {
+        LoadChunk* chunk = &chunks[c];
+
+        // Only the first `count` record lines of the file are loaded
+        int rows = chunk->row_count;
+        int remaining = count - lines_before;
+        while (rows > 0 && chunk->ordinals[rows - 1] >= remaining) {
+            rows--;
+        }
+
+        int result = add_students_batch_locked(manager, chunk->rows, rows, NULL);
+        if (result != SUCCESS) {
+            return result;
+        }
+        lines_before += chunk->line_count;
+    }
+    return SUCCESS;
+}
+
+int load_students_from_file_parallel(StudentManager* manager, const char* filename, int threads) {
+    DEBUG_PRINT("Loading students from file: %s (threads: %d)", filename, threads);
+
+    if (manager == NULL || filename == NULL) {
+        DEBUG_PRINT("Invalid parameters for load_students_from_file_parallel");
+        return ERROR_INVALID_INPUT;
+    }
+
+    MappedFile file;
+    int result = map_file_readonly(filename, &file);
+    if (result != SUCCESS) {
+        return result == ERROR_MEMORY_ALLOCATION ? result : ERROR_FILE_NOT_FOUND;
+    }
+
+    const char* data = file.data;
+    const char* end = data + file.size;
+    int count;
+    const char* records = data ? parse_header(data, end, &count) : NULL;
+    if (records == NULL) {
+        DEBUG_PRINT("Failed to read student count from file");
+        unmap_file(&file);
+        return ERROR_INVALID_INPUT;
+    }
+
+    DEBUG_PRINT("Loading %d students from file", count);
+
+    // Never use more workers than there are megabytes to parse
+    if (threads <= 0) {
+        threads = default_thread_count();
+    }
+    size_t body_size = (size_t)(end - records);
+    size_t max_by_size = body_size / MIN_CHUNK_BYTES + 1;
+    if ((size_t)threads > max_by_size) threads = (int)max_by_size;
+    if (threads > MAX_LOADER_THREADS) threads = MAX_LOADER_THREADS;
+
+    LoadChunk chunks[MAX_LOADER_THREADS];
+    memset(chunks, 0, sizeof(chunks));
+
+    // Split at newline boundaries so no line straddles two chunks
+    const char* chunk_start = records;
+    for (int t = 0; t < threads; t++) {
+        const char* chunk_end = end;
+        if (t < threads - 1) {
+            chunk_end = records + body_size / (size_t)threads * (size_t)(t + 1);
+            if (chunk_end < chunk_start) chunk_end = chunk_start;
+            const char* newline = memchr(chunk_end, '\n', (size_t)(end - chunk_end));
+            chunk_end = newline ? newline + 1 : end;
+        }
+        chunks[t].begin = chunk_start;
+        chunks[t].end = chunk_end;
+        chunk_start = chunk_end;
+    }
+
+#ifndef _WIN32
+    pthread_t workers[MAX_LOADER_THREADS];
+    int started[MAX_LOADER_THREADS] = {0};
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&workers[t], NULL, parse_chunk_thread, &chunks[t]) == 0;
+    }
+    parse_chunk(&chunks[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(workers[t], NULL);
+        } else {
+            parse_chunk(&chunks[t]);    // Fall back to parsing inline
+        }
+    }
+#else
+    for (int t = 0; t < threads; t++) {
+        parse_chunk(&chunks[t]);
+    }
+#endif
+
+    // The header count is untrusted: size the roster by the rows parsed
+    result = SUCCESS;
+    int parsed = 0;
+    for (int t = 0; t < threads; t++) {
+        if (chunks[t].failed) {
+            result = ERROR_MEMORY_ALLOCATION;
+        }
+        parsed += chunks[t].row_count;
+    }
+
+    // Replace the roster only once every chunk has been parsed and merged,
+    // in one update so concurrent readers see either the old or the new
+    // roster and the journal records nothing for a failed load
+    if (result == SUCCESS) {
+        lock_students_exclusive(manager);
+        StudentManager* staging = create_staging_manager(manager, parsed < count ? parsed : count);
+        result = staging != NULL ? merge_chunks(staging, chunks, threads, count)
+                                 : ERROR_MEMORY_ALLOCATION;
+        if (result == SUCCESS) {
+            replace_students_locked(manager, staging);
+        } else {
+            destroy_student_manager(staging);
+        }
+        unlock_students_exclusive(manager);
+    }
+
+    for (int t = 0; t < threads; t++) {
+        free(chunks[t].rows);
+        free(chunks[t].ordinals);
+    }
+    unmap_file(&file);
+
+    DEBUG_PRINT("Successfully loaded %d students from file", get_student_count(manager));
+    return result;
+}
@@ -0,0 +1,18 @@
+#ifndef STUDENT_LOADER_H
+#define STUDENT_LOADER_H
+
+#include "student_manager.h"
+
+// Parallel text import for the "ID,Name,GPA" format written by
+// save_students_to_file. The file is mapped, split at newline boundaries and
+// parsed by worker threads; rows are then merged in file order through
+// add_students_batch, so the result matches a sequential load exactly.
+// Pass threads <= 0 to use one worker per online CPU.
+int load_students_from_file_parallel(StudentManager* manager, const char* filename, int threads);
+
+// Hand-written field parsers used by the loader. Each parses a prefix of
+// [*cursor, end), advances *cursor past it and returns 1 on success.
+int parse_int_field(const char** cursor, const char* end, int* value);
+int parse_double_field(const char** cursor, const char* end, double* value);
+
+#endif // STUDENT_LOADER_H
@@ -1,356 +1,2315 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
 #include "student_manager.h"
+#include "student_manager_internal.h"
+#include "student_loader.h"
+#include "mapped_file.h"
+#include "gpa_kernels.h"
+#include "rw_lock.h"
 #include "config.h"
 
-// Student manager implementation
-struct StudentManager {
-    Student students[MAX_STUDENTS];
-    int count;
-    int capacity;
-};
+// Copies handed out as Student* in the column layout and in thread-safe
+// mode; a few are kept so that expressions using several results at once
+// (e.g. highest and lowest GPA student in one printf) still see distinct
+// records. Each thread has its own set, so concurrent readers never share one.
+#define STUDENT_SCRATCH_RECORDS 4
+
+static _Thread_local Student scratch_records[STUDENT_SCRATCH_RECORDS];
+static _Thread_local int next_scratch_record;
+
+// Resize one storage array to exactly capacity elements
+static int resize_array(void** array, int capacity, size_t element_size) {
+    if (capacity == 0) {
+        free(*array);
+        *array = NULL;
+        return SUCCESS;
+    }
+    
+    if ((size_t)capacity > SIZE_MAX / element_size) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    void* resized = realloc(*array, (size_t)capacity * element_size);
+    if (resized == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    *array = resized;
+    return SUCCESS;
+}
+
+// Resize the record storage to exactly new_capacity slots. A failure part
+// way through the columns leaves some larger than needed, which is harmless
+// because capacity only advances once all of them have been resized.
+static int resize_students(StudentManager* manager, int new_capacity) {
+    int result;
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        result = resize_array((void**)&manager->ids, new_capacity, sizeof(int));
+        if (result == SUCCESS) {
+            result = resize_array((void**)&manager->gpas, new_capacity, sizeof(double));
+        }
+        if (result == SUCCESS) {
+            result = resize_array((void**)&manager->name_offsets, new_capacity, sizeof(uint32_t));
+        }
+    } else {
+        result = resize_array((void**)&manager->students, new_capacity, sizeof(Student));
+    }
+    
+    if (result != SUCCESS) {
+        DEBUG_PRINT("Failed to resize student storage to %d records", new_capacity);
+        return result;
+    }
+    
+    manager->capacity = new_capacity;
+    return SUCCESS;
+}
+
+// Grow geometrically so that at least required records fit
+int reserve_student_slots(StudentManager* manager, int required) {
+    if (required <= manager->capacity) {
+        return SUCCESS;
+    }
+    
+    int new_capacity = manager->capacity > 0 ? manager->capacity : INITIAL_STUDENT_CAPACITY;
+    while (new_capacity < required) {
+        if (new_capacity > INT_MAX / 2) {
+            new_capacity = INT_MAX;
+            break;
+        }
+        new_capacity *= 2;
+    }
+    
+    DEBUG_PRINT("Growing student storage from %d to %d records",
+                manager->capacity, new_capacity);
+    return resize_students(manager, new_capacity);
+}
+
+int reserve_name_storage(StudentManager* manager, int names, size_t bytes) {
+    if (manager->layout != STUDENT_LAYOUT_COLUMNS) {
+        return SUCCESS;
+    }
+    return name_arena_reserve(&manager->names, (size_t)names, bytes);
+}
+
+void store_student(StudentManager* manager, int slot, const Student* student) {
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        manager->ids[slot] = student->id;
+        manager->gpas[slot] = student->gpa;
+        name_arena_append(&manager->names, student->name, &manager->name_offsets[slot]);
+    } else {
+        Student* record = &manager->students[slot];
+        record->id = student->id;
+        strncpy(record->name, student->name, MAX_NAME_LENGTH - 1);
+        record->name[MAX_NAME_LENGTH - 1] = '\0';  // Ensure null termination
+        record->gpa = student->gpa;
+    }
+}
+
+void read_student(const StudentManager* manager, int slot, Student* student) {
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        student->id = manager->ids[slot];
+        strcpy(student->name, name_arena_get(&manager->names, manager->name_offsets[slot]));
+        student->gpa = manager->gpas[slot];
+    } else {
+        *student = manager->students[slot];
+    }
+}
+
+// In thread-safe mode a writer may move the record as soon as the caller
+// releases the lock, so rows are copied out too
+Student* student_at(StudentManager* manager, int slot) {
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS || manager->lock != NULL) {
+        Student* copy = &scratch_records[next_scratch_record];
+        next_scratch_record = (next_scratch_record + 1) % STUDENT_SCRATCH_RECORDS;
+        read_student(manager, slot, copy);
+        return copy;
+    }
+    return &manager->students[slot];
+}
+
+// Re-point every index entry after records have been reordered in place
+void reindex_students(StudentManager* manager) {
+    for (int i = 0; i < manager->count; i++) {
+        id_index_set_slot(&manager->id_index, student_id_at(manager, i), i);
+    }
+}
+
+// Locking. Outside thread-safe mode there is no lock and these do nothing.
+// A NULL manager is accepted so that public functions can lock before they
+// validate their arguments.
+void lock_students_shared(StudentManager* manager) {
+    if (manager != NULL && manager->lock != NULL) {
+        rw_lock_read(manager->lock);
+    }
+}
+
+void unlock_students_shared(StudentManager* manager) {
+    if (manager != NULL && manager->lock != NULL) {
+        rw_lock_read_unlock(manager->lock);
+    }
+}
+
+void lock_students_exclusive(StudentManager* manager) {
+    if (manager != NULL && manager->lock != NULL) {
+        rw_lock_write(manager->lock);
+    }
+}
+
+// Every exclusive section counts as a modification and ends open cursors;
+// whatever it changed is journaled before other threads can see it
+void unlock_students_exclusive(StudentManager* manager) {
+    if (manager != NULL) {
+        manager->generation++;
+        journal_commit(manager);
+        if (manager->lock != NULL) {
+            rw_lock_write_unlock(manager->lock);
+        }
+    }
+}
+
+// Shared lock on a roster without removed slots. Readers may not purge, so
+// pending tombstones are dropped under the exclusive lock first; a writer
+// can slip in between, hence the loop. Purging moves slots but no index
+// nodes, so it leaves cursors open.
+void lock_students_for_scan(StudentManager* manager) {
+    lock_students_shared(manager);
+    while (manager != NULL && manager->tombstones > 0) {
+        if (manager->lock == NULL) {
+            purge_tombstones(manager);
+            break;
+        }
+        rw_lock_read_unlock(manager->lock);
+        rw_lock_write(manager->lock);
+        purge_tombstones(manager);
+        rw_lock_write_unlock(manager->lock);
+        rw_lock_read(manager->lock);
+    }
+}
+
+// Reclaim arena space once most of it belongs to removed students
+static void compact_names_if_sparse(StudentManager* manager) {
+    NameArena* names = &manager->names;
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS &&
+        names->dead > INITIAL_STUDENT_CAPACITY * MAX_NAME_LENGTH && names->dead > names->size / 2) {
+        name_arena_compact(names, manager->name_offsets, (size_t)manager->count);
+    }
+}
+
+static void move_student(StudentManager* manager, int to, int from) {
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        manager->ids[to] = manager->ids[from];
+        manager->gpas[to] = manager->gpas[from];
+        manager->name_offsets[to] = manager->name_offsets[from];
+    } else {
+        manager->students[to] = manager->students[from];
+    }
+}
+
+static void release_name(StudentManager* manager, int slot) {
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        name_arena_release(&manager->names, manager->name_offsets[slot]);
+    }
+}
+
+// STUDENT_REMOVE_SHIFT: close the gap by shifting later records down
+static void shift_out_slot(StudentManager* manager, int slot) {
+    size_t tail = (size_t)(manager->count - slot - 1);
+    release_name(manager, slot);
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        memmove(&manager->ids[slot], &manager->ids[slot + 1], tail * sizeof(int));
+        memmove(&manager->gpas[slot], &manager->gpas[slot + 1], tail * sizeof(double));
+        memmove(&manager->name_offsets[slot], &manager->name_offsets[slot + 1],
+                tail * sizeof(uint32_t));
+    } else {
+        memmove(&manager->students[slot], &manager->students[slot + 1], tail * sizeof(Student));
+    }
+    manager->count--;
+    
+    for (int i = slot; i < manager->count; i++) {
+        id_index_set_slot(&manager->id_index, student_id_at(manager, i), i);
+    }
+    compact_names_if_sparse(manager);
+}
+
+// STUDENT_REMOVE_SWAP: move the last record into the gap
+static void swap_out_slot(StudentManager* manager, int slot) {
+    int last = manager->count - 1;
+    release_name(manager, slot);
+    if (slot != last) {
+        move_student(manager, slot, last);
+        id_index_set_slot(&manager->id_index, student_id_at(manager, slot), slot);
+    }
+    manager->count--;
+    compact_names_if_sparse(manager);
+}
+
+// STUDENT_REMOVE_TOMBSTONE: ID 0 is never valid, so it marks a dead slot
+static void mark_slot_removed(StudentManager* manager, int slot) {
+    release_name(manager, slot);
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        manager->ids[slot] = 0;
+    } else {
+        manager->students[slot].id = 0;
+    }
+    manager->tombstones++;
+}
+
+// Drop every dead slot in one stable pass
+void purge_tombstones(StudentManager* manager) {
+    if (manager->tombstones == 0) {
+        return;
+    }
+    
+    int kept = 0;
+    for (int i = 0; i < manager->count; i++) {
+        int id = student_id_at(manager, i);
+        if (id == 0) {
+            continue;
+        }
+        if (kept != i) {
+            move_student(manager, kept, i);
+            id_index_set_slot(&manager->id_index, id, kept);
+        }
+        kept++;
+    }
+    
+    DEBUG_PRINT("Purged %d removed student slots", manager->tombstones);
+    manager->count = kept;
+    manager->tombstones = 0;
+    compact_names_if_sparse(manager);
+}
+
+// Keep dead slots to at most half of the array, so purging stays amortized
+// O(1) per removal
+static void purge_tombstones_if_sparse(StudentManager* manager) {
+    if (manager->tombstones > manager->count - manager->tombstones) {
+        purge_tombstones(manager);
+    }
+}
+
+static void remove_slot(StudentManager* manager, int slot) {
+    switch (manager->removal_mode) {
+        case STUDENT_REMOVE_SWAP:
+            swap_out_slot(manager, slot);
+            break;
+        case STUDENT_REMOVE_TOMBSTONE:
+            mark_slot_removed(manager, slot);
+            purge_tombstones_if_sparse(manager);
+            break;
+        default:
+            shift_out_slot(manager, slot);
+            break;
+    }
+}
+
+// Reorder the records so that slot i receives the record at order[i]. Only
+// the columns move; names stay where they are in the arena.
+static int permute_students(StudentManager* manager, const int* order) {
+    int n = manager->count;
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        int* ids = malloc((size_t)manager->capacity * sizeof(int));
+        double* gpas = malloc((size_t)manager->capacity * sizeof(double));
+        uint32_t* name_offsets = malloc((size_t)manager->capacity * sizeof(uint32_t));
+        if (ids == NULL || gpas == NULL || name_offsets == NULL) {
+            free(ids);
+            free(gpas);
+            free(name_offsets);
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        for (int i = 0; i < n; i++) {
+            ids[i] = manager->ids[order[i]];
+            gpas[i] = manager->gpas[order[i]];
+            name_offsets[i] = manager->name_offsets[order[i]];
+        }
+        free(manager->ids);
+        free(manager->gpas);
+        free(manager->name_offsets);
+        manager->ids = ids;
+        manager->gpas = gpas;
+        manager->name_offsets = name_offsets;
+    } else {
+        Student* students = malloc((size_t)manager->capacity * sizeof(Student));
+        if (students == NULL) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        for (int i = 0; i < n; i++) {
+            students[i] = manager->students[order[i]];
+        }
+        free(manager->students);
+        manager->students = students;
+    }
+    
+    reindex_students(manager);
+    return SUCCESS;
+}
+
+// Neumaier summation keeps the running total exact to within a rounding
+// step even after millions of additions and removals
+static void add_to_gpa_sum(StudentManager* manager, double value) {
+    double sum = manager->gpa_sum + value;
+    if (fabs(manager->gpa_sum) >= fabs(value)) {
+        manager->gpa_sum_compensation += (manager->gpa_sum - sum) + value;
+    } else {
+        manager->gpa_sum_compensation += (value - sum) + manager->gpa_sum;
+    }
+    manager->gpa_sum = sum;
+}
+
+static void reset_statistics(StudentManager* manager) {
+    ordered_index_clear(&manager->gpa_index);
+    ordered_index_clear(&manager->name_index);
+    manager->gpa_sum = 0.0;
+    manager->gpa_sum_compensation = 0.0;
+}
+
+int index_student(StudentManager* manager, int slot) {
+    int id = student_id_at(manager, slot);
+    double gpa = student_gpa_at(manager, slot);
+    int result;
+    
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        result = ordered_index_insert(&manager->gpa_index, gpa, id);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+    if (manager->indexes & STUDENT_INDEX_NAME) {
+        result = ordered_index_insert_text(&manager->name_index, student_name_at(manager, slot), id);
+        if (result != SUCCESS) {
+            if (manager->indexes & STUDENT_INDEX_GPA) {
+                ordered_index_remove(&manager->gpa_index, gpa, id);
+            }
+            return result;
+        }
+    }
+    add_to_gpa_sum(manager, gpa);
+    return SUCCESS;
+}
+
+// Add the records in [first_slot, first_slot + n) to one secondary index,
+// using entries[] (n elements) as scratch
+static int bulk_index(StudentManager* manager, OrderedIndex* index, int first_slot, int n,
+                      OrderedEntry* entries) {
+    for (int i = 0; i < n; i++) {
+        if (index->key_type == ORDERED_KEY_TEXT) {
+            entries[i].text = student_name_at(manager, first_slot + i);
+        } else {
+            entries[i].key = student_gpa_at(manager, first_slot + i);
+        }
+        entries[i].id = student_id_at(manager, first_slot + i);
+    }
+    return ordered_index_insert_many(index, entries, (size_t)n);
+}
+
+int index_students_bulk(StudentManager* manager, int first_slot, int n) {
+    if (n <= 0) {
+        return SUCCESS;
+    }
+    
+    OrderedEntry* entries = malloc((size_t)n * sizeof(OrderedEntry));
+    if (entries == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    int result = SUCCESS;
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        result = bulk_index(manager, &manager->gpa_index, first_slot, n, entries);
+    }
+    if (result == SUCCESS && (manager->indexes & STUDENT_INDEX_NAME)) {
+        result = bulk_index(manager, &manager->name_index, first_slot, n, entries);
+        if (result != SUCCESS && (manager->indexes & STUDENT_INDEX_GPA)) {
+            for (int i = first_slot; i < first_slot + n; i++) {
+                ordered_index_remove(&manager->gpa_index, student_gpa_at(manager, i),
+                                     student_id_at(manager, i));
+            }
+        }
+    }
+    free(entries);
+    if (result != SUCCESS) {
+        return result;
+    }
+    
+    // Columns hold the batch's GPAs contiguously, so sum them in one pass
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        add_to_gpa_sum(manager, gpa_kernel_sum(&manager->gpas[first_slot], (size_t)n));
+    } else {
+        for (int i = first_slot; i < first_slot + n; i++) {
+            add_to_gpa_sum(manager, student_gpa_at(manager, i));
+        }
+    }
+    return SUCCESS;
+}
+
+void unindex_student(StudentManager* manager, int slot) {
+    int id = student_id_at(manager, slot);
+    double gpa = student_gpa_at(manager, slot);
+    
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        ordered_index_remove(&manager->gpa_index, gpa, id);
+    }
+    if (manager->indexes & STUDENT_INDEX_NAME) {
+        ordered_index_remove_text(&manager->name_index, student_name_at(manager, slot), id);
+    }
+    add_to_gpa_sum(manager, -gpa);
+    
+    // Start from an exact zero again once the last record goes
+    if (live_student_count(manager) == 1) {
+        manager->gpa_sum = 0.0;
+        manager->gpa_sum_compensation = 0.0;
+    }
+}
+
+int set_student_gpa(StudentManager* manager, int slot, double gpa) {
+    int id = student_id_at(manager, slot);
+    double old_gpa = student_gpa_at(manager, slot);
+    if (gpa == old_gpa) {
+        return SUCCESS;
+    }
+    
+    // Insert the new position first so a failed allocation changes nothing
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        int result = ordered_index_insert(&manager->gpa_index, gpa, id);
+        if (result != SUCCESS) {
+            return result;
+        }
+        ordered_index_remove(&manager->gpa_index, old_gpa, id);
+    }
+    
+    add_to_gpa_sum(manager, gpa - old_gpa);
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        manager->gpas[slot] = gpa;
+    } else {
+        manager->students[slot].gpa = gpa;
+    }
+    return SUCCESS;
+}
+
+// GPA scans, used for the statistics when the GPA index is off
+#define GPA_SCAN_BLOCK 256
+
+// Number of GPAs handed to the kernels at once: the whole column, or a
+// stack-sized batch gathered from the rows
+static int gpa_scan_step(const StudentManager* manager) {
+    return manager->layout == STUDENT_LAYOUT_COLUMNS ? manager->count : GPA_SCAN_BLOCK;
+}
+
+// Contiguous view of the GPAs of slots [start, start + n)
+static const double* gpa_block(const StudentManager* manager, int start, int n, double* buffer) {
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        return &manager->gpas[start];
+    }
+    for (int i = 0; i < n; i++) {
+        buffer[i] = manager->students[start + i].gpa;
+    }
+    return buffer;
+}
+
+// Slots holding the first lowest and first highest GPA
+static void scan_gpa_extremes(const StudentManager* manager, int* lowest, int* highest) {
+    double buffer[GPA_SCAN_BLOCK];
+    int step = gpa_scan_step(manager);
+    *lowest = 0;
+    *highest = 0;
+    
+    for (int start = 0; start < manager->count; start += step) {
+        int n = manager->count - start < step ? manager->count - start : step;
+        const double* values = gpa_block(manager, start, n, buffer);
+        size_t low, high;
+        gpa_kernel_min_max(values, (size_t)n, &low, &high);
+        if (values[low] < student_gpa_at(manager, *lowest)) *lowest = start + (int)low;
+        if (values[high] > student_gpa_at(manager, *highest)) *highest = start + (int)high;
+    }
+}
+
+// Slot of the lowest ID among the records with exactly this GPA, matching
+// the tie rule of the GPA index
+static int scan_lowest_id_with_gpa(const StudentManager* manager, double gpa) {
+    double buffer[GPA_SCAN_BLOCK];
+    int step = gpa_scan_step(manager);
+    int best = -1;
+    
+    for (int start = 0; start < manager->count; start += step) {
+        int n = manager->count - start < step ? manager->count - start : step;
+        const double* values = gpa_block(manager, start, n, buffer);
+        size_t i = gpa_kernel_find(values, (size_t)n, gpa);
+        while (i < (size_t)n) {
+            int slot = start + (int)i;
+            if (best == -1 || student_id_at(manager, slot) < student_id_at(manager, best)) {
+                best = slot;
+            }
+            i += 1 + gpa_kernel_find(values + i + 1, (size_t)n - i - 1, gpa);
+        }
+    }
+    return best;
+}
 
 // Constructor and destructor
 StudentManager* create_student_manager(void) {
-    DEBUG_PRINT("Creating student manager");
+    return create_student_manager_with_capacity(0);
+}
+
+StudentManager* create_student_manager_with_capacity(int capacity_hint) {
+    return create_student_manager_with_layout(STUDENT_LAYOUT_ROWS, capacity_hint);
+}
+
+StudentManager* create_student_manager_with_layout(StudentLayout layout, int capacity_hint) {
+    DEBUG_PRINT("Creating student manager (layout: %d, capacity hint: %d)", (int)layout, capacity_hint);
+    
+    if (layout != STUDENT_LAYOUT_ROWS && layout != STUDENT_LAYOUT_COLUMNS) {
+        DEBUG_PRINT("Unknown student layout: %d", (int)layout);
+        return NULL;
+    }
+    
     StudentManager* manager = malloc(sizeof(StudentManager));
     if (manager == NULL) {
         DEBUG_PRINT("Failed to allocate memory for student manager");
         return NULL;
     }
     
+    manager->layout = layout;
     manager->count = 0;
-    manager->capacity = MAX_STUDENTS;
+    manager->capacity = 0;
+    manager->tombstones = 0;
+    manager->removal_mode = STUDENT_REMOVE_SHIFT;
+    manager->students = NULL;
+    manager->ids = NULL;
+    manager->gpas = NULL;
+    manager->name_offsets = NULL;
+    name_arena_init(&manager->names);
+    id_index_init(&manager->id_index);
+    manager->indexes = STUDENT_INDEX_GPA | STUDENT_INDEX_NAME;
+    ordered_index_init(&manager->gpa_index, ORDERED_KEY_NUMBER);
+    ordered_index_init(&manager->name_index, ORDERED_KEY_TEXT);
+    manager->gpa_sum = 0.0;
+    manager->gpa_sum_compensation = 0.0;
+    manager->lock = NULL;
+    manager->generation = 0;
+    manager->journal = NULL;
+    
+    // Pre-size both the records and the index so bulk loads never rehash
+    if (capacity_hint > 0) {
+        if (resize_students(manager, capacity_hint) != SUCCESS ||
+            id_index_reserve(&manager->id_index, (size_t)capacity_hint) != SUCCESS) {
+            destroy_student_manager(manager);
+            return NULL;
+        }
+    }
     
     DEBUG_PRINT("Student manager created successfully");
     return manager;
 }
 
-void destroy_student_manager(StudentManager* manager) {
-    DEBUG_PRINT("Destroying student manager");
-    if (manager != NULL) {
-        free(manager);
-        DEBUG_PRINT("Student manager destroyed");
+void destroy_student_manager(StudentManager* manager) {
+    DEBUG_PRINT("Destroying student manager");
+    if (manager != NULL) {
+        id_index_free(&manager->id_index);
+        ordered_index_free(&manager->gpa_index);
+        ordered_index_free(&manager->name_index);
+        free(manager->students);
+        free(manager->ids);
+        free(manager->gpas);
+        free(manager->name_offsets);
+        name_arena_free(&manager->names);
+        rw_lock_destroy(manager->lock);
+        journal_free(manager);
+        free(manager);
+        DEBUG_PRINT("Student manager destroyed");
+    }
+}
+
+// The copy is built as an empty manager whose storage is then filled with
+// bulk copies; with no indexes there is nothing else to maintain
+StudentManager* copy_student_records(const StudentManager* manager) {
+    StudentManager* copy = create_student_manager_with_layout(manager->layout, 0);
+    if (copy == NULL) {
+        return NULL;
+    }
+    copy->indexes = 0;
+    
+    int count = manager->count;
+    if (resize_students(copy, count) != SUCCESS ||
+        name_arena_reserve(&copy->names, 0, manager->names.size) != SUCCESS) {
+        destroy_student_manager(copy);
+        return NULL;
+    }
+    
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        memcpy(copy->ids, manager->ids, (size_t)count * sizeof(int));
+        memcpy(copy->gpas, manager->gpas, (size_t)count * sizeof(double));
+        memcpy(copy->name_offsets, manager->name_offsets, (size_t)count * sizeof(uint32_t));
+        if (manager->names.size > 0) {
+            memcpy(copy->names.data, manager->names.data, manager->names.size);
+        }
+        copy->names.size = manager->names.size;
+        copy->names.dead = manager->names.dead;
+    } else if (count > 0) {
+        memcpy(copy->students, manager->students, (size_t)count * sizeof(Student));
+    }
+    copy->count = count;
+    return copy;
+}
+
+// The staging manager starts empty with the same settings, so whatever is
+// built into it can replace the roster as is
+StudentManager* create_staging_manager(const StudentManager* manager, int capacity_hint) {
+    StudentManager* staging = create_student_manager_with_layout(manager->layout, capacity_hint);
+    if (staging == NULL) {
+        return NULL;
+    }
+    staging->removal_mode = manager->removal_mode;
+    staging->indexes = manager->indexes;
+    if (name_arena_set_interning(&staging->names, manager->names.interning, NULL, 0) != SUCCESS) {
+        destroy_student_manager(staging);
+        return NULL;
+    }
+    return staging;
+}
+
+void replace_students_locked(StudentManager* manager, StudentManager* staging) {
+    StudentManager previous = *manager;
+    
+    *manager = *staging;
+    manager->lock = previous.lock;
+    manager->generation = previous.generation;
+    manager->journal = previous.journal;
+    
+    // The staging shell takes the old roster away and frees it
+    *staging = previous;
+    staging->lock = NULL;
+    staging->journal = NULL;
+    destroy_student_manager(staging);
+    
+    journal_log_clear(manager);
+    journal_log_students(manager, 0, manager->count);
+}
+
+// Student management functions
+int add_student_locked(StudentManager* manager, int id, const char* name, double gpa) {
+    DEBUG_PRINT("Adding student: ID=%d, Name=%s, GPA=%.2f", id, name, gpa);
+    
+    if (manager == NULL || name == NULL) {
+        DEBUG_PRINT("Invalid parameters for add_student");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    if (!is_valid_student_id(id)) {
+        DEBUG_PRINT("Invalid student ID: %d", id);
+        return ERROR_INVALID_INPUT;
+    }
+    
+    if (!is_valid_gpa(gpa)) {
+        DEBUG_PRINT("Invalid GPA: %.2f", gpa);
+        return ERROR_INVALID_INPUT;
+    }
+    
+    if (manager->count == INT_MAX ||
+        reserve_student_slots(manager, manager->count + 1) != SUCCESS ||
+        reserve_name_storage(manager, 1, name_arena_stored_size(name)) != SUCCESS) {
+        DEBUG_PRINT("Unable to grow student storage");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    // Registering the ID doubles as the duplicate check
+    int result = id_index_insert(&manager->id_index, id, manager->count);
+    if (result == ERROR_STUDENT_EXISTS) {
+        DEBUG_PRINT("Student with ID %d already exists", id);
+        return ERROR_STUDENT_EXISTS;
+    }
+    if (result != SUCCESS) {
+        DEBUG_PRINT("Failed to index student with ID %d", id);
+        return result;
+    }
+    
+    // Add new student
+    Student new_student;
+    new_student.id = id;
+    strncpy(new_student.name, name, MAX_NAME_LENGTH - 1);
+    new_student.name[MAX_NAME_LENGTH - 1] = '\0';  // Ensure null termination
+    new_student.gpa = gpa;
+    
+    size_t names_size = manager->names.size;
+    store_student(manager, manager->count, &new_student);
+    
+    if (index_student(manager, manager->count) != SUCCESS) {
+        DEBUG_PRINT("Failed to update statistics for student %d", id);
+        id_index_remove(&manager->id_index, id);
+        release_name(manager, manager->count);
+        name_arena_truncate(&manager->names, names_size);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    journal_log_students(manager, manager->count, 1);
+    manager->count++;
+    DEBUG_PRINT("Student added successfully. Total students: %d", live_student_count(manager));
+    return SUCCESS;
+}
+
+int add_student(StudentManager* manager, int id, const char* name, double gpa) {
+    lock_students_exclusive(manager);
+    int result = add_student_locked(manager, id, name, gpa);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+int remove_student_locked(StudentManager* manager, int id) {
+    DEBUG_PRINT("Removing student with ID: %d", id);
+    
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    int index = id_index_find(&manager->id_index, id);
+    if (index == -1) {
+        DEBUG_PRINT("Student with ID %d not found", id);
+        return ERROR_STUDENT_NOT_FOUND;
+    }
+    id_index_remove(&manager->id_index, id);
+    unindex_student(manager, index);
+    
+    remove_slot(manager, index);
+    journal_log_removal(manager, id);
+    DEBUG_PRINT("Student removed successfully. Total students: %d", live_student_count(manager));
+    return SUCCESS;
+}
+
+int remove_student(StudentManager* manager, int id) {
+    lock_students_exclusive(manager);
+    int result = remove_student_locked(manager, id);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+static Student* find_student_locked(StudentManager* manager, int id) {
+    DEBUG_PRINT("Finding student with ID: %d", id);
+    
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return NULL;
+    }
+    
+    int index = id_index_find(&manager->id_index, id);
+    if (index != -1) {
+        DEBUG_PRINT("Student found at index %d", index);
+        return student_at(manager, index);
+    }
+    
+    DEBUG_PRINT("Student with ID %d not found", id);
+    return NULL;
+}
+
+Student* find_student(StudentManager* manager, int id) {
+    lock_students_shared(manager);
+    Student* result = find_student_locked(manager, id);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static int get_student_locked(StudentManager* manager, int id, Student* student) {
+    if (manager == NULL || student == NULL) {
+        DEBUG_PRINT("Invalid parameters for get_student");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    int index = id_index_find(&manager->id_index, id);
+    if (index == -1) {
+        return ERROR_STUDENT_NOT_FOUND;
+    }
+    
+    read_student(manager, index, student);
+    return SUCCESS;
+}
+
+int get_student(StudentManager* manager, int id, Student* student) {
+    lock_students_shared(manager);
+    int result = get_student_locked(manager, id, student);
+    unlock_students_shared(manager);
+    return result;
+}
+
+int update_student_gpa_locked(StudentManager* manager, int id, double new_gpa) {
+    DEBUG_PRINT("Updating GPA for student ID %d to %.2f", id, new_gpa);
+    
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    if (!is_valid_gpa(new_gpa)) {
+        DEBUG_PRINT("Invalid GPA: %.2f", new_gpa);
+        return ERROR_INVALID_INPUT;
+    }
+    
+    int index = id_index_find(&manager->id_index, id);
+    if (index == -1) {
+        DEBUG_PRINT("Student with ID %d not found", id);
+        return ERROR_STUDENT_NOT_FOUND;
+    }
+    
+    int result = set_student_gpa(manager, index, new_gpa);
+    if (result != SUCCESS) {
+        DEBUG_PRINT("Failed to re-index GPA for student %d", id);
+        return result;
+    }
+    journal_log_gpa(manager, id, new_gpa);
+    
+    DEBUG_PRINT("GPA updated to %.2f", new_gpa);
+    return SUCCESS;
+}
+
+int update_student_gpa(StudentManager* manager, int id, double new_gpa) {
+    lock_students_exclusive(manager);
+    int result = update_student_gpa_locked(manager, id, new_gpa);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+int get_student_count(StudentManager* manager) {
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return 0;
+    }
+    
+    lock_students_shared(manager);
+    int count = live_student_count(manager);
+    unlock_students_shared(manager);
+    return count;
+}
+
+// Rows are processed in blocks so the per-row scratch flags stay on the stack
+#define BATCH_BLOCK_SIZE 4096
+
+// Flag each row that passes ID and GPA range checks. Written without
+// branches or calls so the compiler can vectorize it.
+static void validate_batch_block(const Student* rows, int n, unsigned char* ok) {
+    for (int i = 0; i < n; i++) {
+        int id = rows[i].id;
+        double gpa = rows[i].gpa;
+        ok[i] = (unsigned char)((id > 0) & (id <= MAX_STUDENT_ID) &
+                                (gpa >= MIN_GPA) & (gpa <= MAX_GPA));
+    }
+}
+
+int add_students_batch_locked(StudentManager* manager, const Student* students, int n,
+                              StudentBatchReport* report) {
+    DEBUG_PRINT("Adding batch of %d students", n);
+    
+    if (manager == NULL || (students == NULL && n > 0) || n < 0) {
+        DEBUG_PRINT("Invalid parameters for add_students_batch");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    StudentBatchReport local = {0, 0, 0, NULL};
+    if (report == NULL) {
+        report = &local;
+    }
+    report->added = 0;
+    report->invalid = 0;
+    report->duplicates = 0;
+    if (report->error_bitmap != NULL) {
+        memset(report->error_bitmap, 0, ((size_t)n + 63) / 64 * sizeof(uint64_t));
+    }
+    
+    // Size storage and index for the whole batch so nothing grows mid-flight
+    if (n > INT_MAX - manager->count ||
+        reserve_student_slots(manager, manager->count + n) != SUCCESS ||
+        id_index_reserve(&manager->id_index, (size_t)manager->count + (size_t)n) != SUCCESS) {
+        DEBUG_PRINT("Unable to reserve space for batch");
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        size_t name_bytes = 0;
+        for (int i = 0; i < n; i++) {
+            name_bytes += name_arena_stored_size(students[i].name);
+        }
+        if (reserve_name_storage(manager, n, name_bytes) != SUCCESS) {
+            DEBUG_PRINT("Unable to reserve name storage for batch");
+            return ERROR_MEMORY_ALLOCATION;
+        }
+    }
+    
+    // Accepted rows are added to the secondary indexes in one bulk step
+    int first_slot = manager->count;
+    size_t names_size = manager->names.size;
+    
+    unsigned char ok[BATCH_BLOCK_SIZE];
+    for (int base = 0; base < n; base += BATCH_BLOCK_SIZE) {
+        int block = n - base < BATCH_BLOCK_SIZE ? n - base : BATCH_BLOCK_SIZE;
+        const Student* rows = students + base;
+        
+        // Pass 1: range validation
+        validate_batch_block(rows, block, ok);
+        
+        // Pass 2: duplicate detection against existing records and earlier
+        // rows; registering the ID also reserves its final slot
+        int next_slot = manager->count;
+        for (int i = 0; i < block; i++) {
+            if (!ok[i]) {
+                report->invalid++;
+            } else if (id_index_insert(&manager->id_index, rows[i].id, next_slot) != SUCCESS) {
+                report->duplicates++;
+                ok[i] = 0;
+            } else {
+                next_slot++;
+                continue;
+            }
+            if (report->error_bitmap != NULL) {
+                size_t row = (size_t)base + (size_t)i;
+                report->error_bitmap[row / 64] |= (uint64_t)1 << (row % 64);
+            }
+        }
+        
+        // Pass 3: append accepted rows, as contiguous runs when the records
+        // are stored whole and field by field into the columns otherwise
+        if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+            int slot = manager->count;
+            for (int i = 0; i < block; i++) {
+                if (ok[i]) {
+                    store_student(manager, slot++, &rows[i]);
+                }
+            }
+        } else {
+            Student* dest = &manager->students[manager->count];
+            for (int i = 0; i < block; ) {
+                if (!ok[i]) {
+                    i++;
+                    continue;
+                }
+                int run_end = i + 1;
+                while (run_end < block && ok[run_end]) {
+                    run_end++;
+                }
+                memcpy(dest, &rows[i], (size_t)(run_end - i) * sizeof(Student));
+                dest += run_end - i;
+                i = run_end;
+            }
+            for (int i = manager->count; i < next_slot; i++) {
+                manager->students[i].name[MAX_NAME_LENGTH - 1] = '\0';
+            }
+        }
+        
+        int appended = next_slot - manager->count;
+        manager->count = next_slot;
+        report->added += appended;
+    }
+    
+    // If the indexes cannot absorb the batch, roll it back entirely
+    int result = index_students_bulk(manager, first_slot, report->added);
+    if (result != SUCCESS) {
+        DEBUG_PRINT("Failed to index batch, rolling back %d students", report->added);
+        for (int i = first_slot; i < manager->count; i++) {
+            id_index_remove(&manager->id_index, student_id_at(manager, i));
+            release_name(manager, i);
+        }
+        manager->count = first_slot;
+        name_arena_truncate(&manager->names, names_size);
+        report->added = 0;
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    journal_log_students(manager, first_slot, report->added);
+    DEBUG_PRINT("Batch added %d students (%d invalid, %d duplicates)",
+                report->added, report->invalid, report->duplicates);
+    return SUCCESS;
+}
+
+int add_students_batch(StudentManager* manager, const Student* students, int n,
+                       StudentBatchReport* report) {
+    lock_students_exclusive(manager);
+    int result = add_students_batch_locked(manager, students, n, report);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+static int remove_students_batch_locked(StudentManager* manager, const int* ids, int n, int* removed) {
+    DEBUG_PRINT("Batch removing %d students", n);
+    
+    if (removed != NULL) {
+        *removed = 0;
+    }
+    if (manager == NULL || n < 0 || (ids == NULL && n > 0)) {
+        DEBUG_PRINT("Invalid parameters for remove_students_batch");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    // Outside SWAP mode every removal only marks its slot; SHIFT then closes
+    // all the gaps together in one pass over the array
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        int slot = id_index_find(&manager->id_index, ids[i]);
+        if (slot == -1) {
+            continue;
+        }
+        id_index_remove(&manager->id_index, ids[i]);
+        unindex_student(manager, slot);
+        if (manager->removal_mode == STUDENT_REMOVE_SWAP) {
+            swap_out_slot(manager, slot);
+        } else {
+            mark_slot_removed(manager, slot);
+        }
+        journal_log_removal(manager, ids[i]);
+        count++;
+    }
+    
+    if (manager->removal_mode == STUDENT_REMOVE_TOMBSTONE) {
+        purge_tombstones_if_sparse(manager);
+    } else {
+        purge_tombstones(manager);
+    }
+    
+    if (removed != NULL) {
+        *removed = count;
+    }
+    DEBUG_PRINT("Batch removed %d students. Total students: %d", count, live_student_count(manager));
+    return SUCCESS;
+}
+
+int remove_students_batch(StudentManager* manager, const int* ids, int n, int* removed) {
+    lock_students_exclusive(manager);
+    int result = remove_students_batch_locked(manager, ids, n, removed);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+// Storage management
+StudentLayout get_student_layout(StudentManager* manager) {
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return STUDENT_LAYOUT_ROWS;
+    }
+    
+    return manager->layout;
+}
+
+int get_student_capacity(StudentManager* manager) {
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return 0;
+    }
+    
+    lock_students_shared(manager);
+    int capacity = manager->capacity;
+    unlock_students_shared(manager);
+    return capacity;
+}
+
+static int shrink_student_manager_to_fit_locked(StudentManager* manager) {
+    DEBUG_PRINT("Shrinking student storage to fit");
+    
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    purge_tombstones(manager);
+    if (manager->capacity > manager->count) {
+        int result = resize_students(manager, manager->count);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+    
+    // Rewriting the arena also drops the names of removed students
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+        int result = manager->names.dead > 0
+            ? name_arena_compact(&manager->names, manager->name_offsets, (size_t)manager->count)
+            : name_arena_shrink_to_fit(&manager->names);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+    
+    DEBUG_PRINT("Student storage now holds %d records", manager->capacity);
+    return id_index_shrink_to_fit(&manager->id_index);
+}
+
+int shrink_student_manager_to_fit(StudentManager* manager) {
+    lock_students_exclusive(manager);
+    int result = shrink_student_manager_to_fit_locked(manager);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+static int set_student_indexes_locked(StudentManager* manager, int indexes) {
+    DEBUG_PRINT("Setting secondary indexes to %#x", (unsigned)indexes);
+    
+    if (manager == NULL || (indexes & ~(STUDENT_INDEX_GPA | STUDENT_INDEX_NAME)) != 0) {
+        DEBUG_PRINT("Invalid parameters for set_student_indexes");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    // Build newly enabled indexes over the whole roster before changing
+    // anything, so a failed allocation leaves the previous set in place
+    purge_tombstones(manager);
+    int added = indexes & ~manager->indexes;
+    if (added != 0 && manager->count > 0) {
+        OrderedEntry* entries = malloc((size_t)manager->count * sizeof(OrderedEntry));
+        if (entries == NULL) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+        int result = SUCCESS;
+        if (added & STUDENT_INDEX_GPA) {
+            result = bulk_index(manager, &manager->gpa_index, 0, manager->count, entries);
+        }
+        if (result == SUCCESS && (added & STUDENT_INDEX_NAME)) {
+            result = bulk_index(manager, &manager->name_index, 0, manager->count, entries);
+        }
+        free(entries);
+        if (result != SUCCESS) {
+            if (added & STUDENT_INDEX_GPA) ordered_index_free(&manager->gpa_index);
+            if (added & STUDENT_INDEX_NAME) ordered_index_free(&manager->name_index);
+            return result;
+        }
+    }
+    
+    if (!(indexes & STUDENT_INDEX_GPA)) ordered_index_free(&manager->gpa_index);
+    if (!(indexes & STUDENT_INDEX_NAME)) ordered_index_free(&manager->name_index);
+    manager->indexes = indexes;
+    return SUCCESS;
+}
+
+int set_student_indexes(StudentManager* manager, int indexes) {
+    lock_students_exclusive(manager);
+    int result = set_student_indexes_locked(manager, indexes);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+int get_student_indexes(StudentManager* manager) {
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return 0;
+    }
+    
+    lock_students_shared(manager);
+    int indexes = manager->indexes;
+    unlock_students_shared(manager);
+    return indexes;
+}
+
+static int set_student_removal_mode_locked(StudentManager* manager, StudentRemovalMode mode) {
+    DEBUG_PRINT("Setting removal mode to %d", (int)mode);
+    
+    if (manager == NULL || (mode != STUDENT_REMOVE_SHIFT && mode != STUDENT_REMOVE_SWAP &&
+                            mode != STUDENT_REMOVE_TOMBSTONE)) {
+        DEBUG_PRINT("Invalid parameters for set_student_removal_mode");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    // Only TOMBSTONE mode leaves dead slots behind
+    purge_tombstones(manager);
+    manager->removal_mode = mode;
+    return SUCCESS;
+}
+
+int set_student_removal_mode(StudentManager* manager, StudentRemovalMode mode) {
+    lock_students_exclusive(manager);
+    int result = set_student_removal_mode_locked(manager, mode);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+StudentRemovalMode get_student_removal_mode(StudentManager* manager) {
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return STUDENT_REMOVE_SHIFT;
+    }
+    
+    lock_students_shared(manager);
+    StudentRemovalMode mode = manager->removal_mode;
+    unlock_students_shared(manager);
+    return mode;
+}
+
+// Not itself synchronized: switch modes before sharing the manager between
+// threads or after they have all finished with it
+int set_student_thread_safe(StudentManager* manager, int enabled) {
+    DEBUG_PRINT("Setting thread-safe mode to %d", enabled);
+    
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    if (enabled && manager->lock == NULL) {
+        manager->lock = rw_lock_create();
+        if (manager->lock == NULL) {
+            return ERROR_MEMORY_ALLOCATION;
+        }
+    } else if (!enabled && manager->lock != NULL) {
+        rw_lock_destroy(manager->lock);
+        manager->lock = NULL;
+    }
+    return SUCCESS;
+}
+
+int get_student_thread_safe(StudentManager* manager) {
+    return manager != NULL && manager->lock != NULL;
+}
+
+// Drop removed slots and, in the column layout, the names they left behind
+static int compact_student_storage_locked(StudentManager* manager) {
+    DEBUG_PRINT("Compacting student storage");
+    
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    purge_tombstones(manager);
+    if (manager->layout == STUDENT_LAYOUT_COLUMNS && manager->names.dead > 0) {
+        return name_arena_compact(&manager->names, manager->name_offsets, (size_t)manager->count);
+    }
+    return SUCCESS;
+}
+
+int compact_student_storage(StudentManager* manager) {
+    lock_students_exclusive(manager);
+    int result = compact_student_storage_locked(manager);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+static int set_student_name_interning_locked(StudentManager* manager, int enabled) {
+    DEBUG_PRINT("Setting name interning: %d", enabled);
+    
+    if (manager == NULL || (enabled && manager->layout != STUDENT_LAYOUT_COLUMNS)) {
+        DEBUG_PRINT("Name interning needs the column layout");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    // Removed slots still name released strings, so they must go first
+    purge_tombstones(manager);
+    return name_arena_set_interning(&manager->names, enabled, manager->name_offsets,
+                                    (size_t)manager->count);
+}
+
+int set_student_name_interning(StudentManager* manager, int enabled) {
+    lock_students_exclusive(manager);
+    int result = set_student_name_interning_locked(manager, enabled);
+    unlock_students_exclusive(manager);
+    return result;
+}
+
+int get_student_name_interning(StudentManager* manager) {
+    lock_students_shared(manager);
+    int result = manager != NULL && manager->names.interning;
+    unlock_students_shared(manager);
+    return result;
+}
+
+// Display functions
+void display_student(const Student* student) {
+    if (student == NULL) {
+        printf("Invalid student\n");
+        return;
+    }
+    
+    printf("ID: %d, Name: %-20s, GPA: %.2f\n", 
+           student->id, student->name, student->gpa);
+}
+
+static void display_all_students_locked(StudentManager* manager) {
+    DEBUG_PRINT("Displaying all students");
+    
+    if (manager == NULL) {
+        printf("Invalid student manager\n");
+        return;
+    }
+    
+    if (live_student_count(manager) == 0) {
+        printf("No students in the system\n");
+        return;
+    }
+    
+    printf("%-5s %-20s %-5s\n", "ID", "Name", "GPA");
+    printf("%-5s %-20s %-5s\n", "---", "--------------------", "-----");
+    
+    for (int i = 0; i < manager->count; i++) {
+        Student student;
+        read_student(manager, i, &student);
+        display_student(&student);
+    }
+}
+
+void display_all_students(StudentManager* manager) {
+    lock_students_for_scan(manager);
+    display_all_students_locked(manager);
+    unlock_students_shared(manager);
+}
+
+// Statistics functions
+// The average comes from the running sum in O(1). Extremes come from the
+// (GPA, ID) index in O(log n), or from a vectorized scan of the GPAs when
+// that index is off; either way ties go to the lower ID.
+static double calculate_average_gpa_locked(StudentManager* manager) {
+    DEBUG_PRINT("Calculating average GPA");
+    
+    if (manager == NULL || live_student_count(manager) == 0) {
+        DEBUG_PRINT("No students for GPA calculation");
+        return 0.0;
+    }
+    
+    double average = (manager->gpa_sum + manager->gpa_sum_compensation) / live_student_count(manager);
+    DEBUG_PRINT("Average GPA: %.2f", average);
+    return average;
+}
+
+double calculate_average_gpa(StudentManager* manager) {
+    lock_students_shared(manager);
+    double result = calculate_average_gpa_locked(manager);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static double calculate_highest_gpa_locked(StudentManager* manager) {
+    DEBUG_PRINT("Finding highest GPA");
+    
+    if (manager == NULL || live_student_count(manager) == 0) {
+        DEBUG_PRINT("No students for highest GPA calculation");
+        return 0.0;
+    }
+    
+    double highest;
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        highest = ordered_index_last(&manager->gpa_index)->key;
+    } else {
+        int lowest_slot, highest_slot;
+        scan_gpa_extremes(manager, &lowest_slot, &highest_slot);
+        highest = student_gpa_at(manager, highest_slot);
+    }
+    DEBUG_PRINT("Highest GPA: %.2f", highest);
+    return highest;
+}
+
+double calculate_highest_gpa(StudentManager* manager) {
+    lock_students_for_scan(manager);
+    double result = calculate_highest_gpa_locked(manager);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static double calculate_lowest_gpa_locked(StudentManager* manager) {
+    DEBUG_PRINT("Finding lowest GPA");
+    
+    if (manager == NULL || live_student_count(manager) == 0) {
+        DEBUG_PRINT("No students for lowest GPA calculation");
+        return 0.0;
+    }
+    
+    double lowest;
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        lowest = ordered_index_first(&manager->gpa_index)->key;
+    } else {
+        int lowest_slot, highest_slot;
+        scan_gpa_extremes(manager, &lowest_slot, &highest_slot);
+        lowest = student_gpa_at(manager, lowest_slot);
+    }
+    DEBUG_PRINT("Lowest GPA: %.2f", lowest);
+    return lowest;
+}
+
+double calculate_lowest_gpa(StudentManager* manager) {
+    lock_students_for_scan(manager);
+    double result = calculate_lowest_gpa_locked(manager);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static Student* find_student_with_highest_gpa_locked(StudentManager* manager) {
+    DEBUG_PRINT("Finding student with highest GPA");
+    
+    if (manager == NULL || live_student_count(manager) == 0) {
+        DEBUG_PRINT("No students available");
+        return NULL;
+    }
+    
+    // The first entry carrying the top GPA is the one with the lowest ID
+    int slot;
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        double highest = ordered_index_last(&manager->gpa_index)->key;
+        const OrderedNode* node = ordered_index_lower_bound(&manager->gpa_index, highest);
+        slot = id_index_find(&manager->id_index, node->id);
+    } else {
+        int lowest_slot;
+        scan_gpa_extremes(manager, &lowest_slot, &slot);
+        slot = scan_lowest_id_with_gpa(manager, student_gpa_at(manager, slot));
+    }
+    Student* highest_student = student_at(manager, slot);
+    
+    DEBUG_PRINT("Student with highest GPA: %s (%.2f)", 
+                highest_student->name, highest_student->gpa);
+    return highest_student;
+}
+
+Student* find_student_with_highest_gpa(StudentManager* manager) {
+    lock_students_for_scan(manager);
+    Student* result = find_student_with_highest_gpa_locked(manager);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static Student* find_student_with_lowest_gpa_locked(StudentManager* manager) {
+    DEBUG_PRINT("Finding student with lowest GPA");
+    
+    if (manager == NULL || live_student_count(manager) == 0) {
+        DEBUG_PRINT("No students available");
+        return NULL;
+    }
+    
+    int slot;
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        const OrderedNode* node = ordered_index_first(&manager->gpa_index);
+        slot = id_index_find(&manager->id_index, node->id);
+    } else {
+        int highest_slot;
+        scan_gpa_extremes(manager, &slot, &highest_slot);
+        slot = scan_lowest_id_with_gpa(manager, student_gpa_at(manager, slot));
+    }
+    Student* lowest_student = student_at(manager, slot);
+    
+    DEBUG_PRINT("Student with lowest GPA: %s (%.2f)", 
+                lowest_student->name, lowest_student->gpa);
+    return lowest_student;
+}
+
+Student* find_student_with_lowest_gpa(StudentManager* manager) {
+    lock_students_for_scan(manager);
+    Student* result = find_student_with_lowest_gpa_locked(manager);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static int count_students_in_gpa_range_locked(StudentManager* manager, double min_gpa, double max_gpa) {
+    DEBUG_PRINT("Counting students with GPA in [%.2f, %.2f]", min_gpa, max_gpa);
+    
+    if (manager == NULL) {
+        DEBUG_PRINT("Invalid manager parameter");
+        return 0;
+    }
+    
+    double buffer[GPA_SCAN_BLOCK];
+    int step = gpa_scan_step(manager);
+    size_t count = 0;
+    for (int start = 0; start < manager->count; start += step) {
+        int n = manager->count - start < step ? manager->count - start : step;
+        count += gpa_kernel_count_in_range(gpa_block(manager, start, n, buffer), (size_t)n,
+                                           min_gpa, max_gpa);
+    }
+    return (int)count;
+}
+
+int count_students_in_gpa_range(StudentManager* manager, double min_gpa, double max_gpa) {
+    lock_students_for_scan(manager);
+    int result = count_students_in_gpa_range_locked(manager, min_gpa, max_gpa);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static int calculate_gpa_histogram_locked(StudentManager* manager, int buckets, int* counts) {
+    DEBUG_PRINT("Building GPA histogram with %d buckets", buckets);
+    
+    if (manager == NULL || buckets <= 0 || counts == NULL) {
+        DEBUG_PRINT("Invalid parameters for calculate_gpa_histogram");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    uint64_t* totals = calloc((size_t)buckets, sizeof(uint64_t));
+    if (totals == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    double buffer[GPA_SCAN_BLOCK];
+    int step = gpa_scan_step(manager);
+    for (int start = 0; start < manager->count; start += step) {
+        int n = manager->count - start < step ? manager->count - start : step;
+        gpa_kernel_histogram(gpa_block(manager, start, n, buffer), (size_t)n,
+                             MIN_GPA, MAX_GPA, (size_t)buckets, totals);
+    }
+    
+    for (int i = 0; i < buckets; i++) {
+        counts[i] = (int)totals[i];
+    }
+    free(totals);
+    return SUCCESS;
+}
+
+int calculate_gpa_histogram(StudentManager* manager, int buckets, int* counts) {
+    lock_students_for_scan(manager);
+    int result = calculate_gpa_histogram_locked(manager, buckets, counts);
+    unlock_students_shared(manager);
+    return result;
+}
+
+// Top-K and percentiles
+// Neither reorders the records: top_k_by_gpa keeps a bounded heap of the k
+// best seen so far, gpa_percentile runs quickselect on a copy of the GPAs.
+
+// A record competing for a top-K place
+typedef struct {
+    double gpa;
+    int id;
+    int slot;
+} TopKEntry;
+
+// Rank order of top_k_by_gpa: higher GPA first, ties to the lower ID
+static int top_k_ranks_before(const TopKEntry* a, const TopKEntry* b) {
+    return a->gpa > b->gpa || (a->gpa == b->gpa && a->id < b->id);
+}
+
+// Restore the heap below position i; the root is the weakest entry kept
+static void top_k_sift_down(TopKEntry* heap, int size, int i) {
+    for (;;) {
+        int weakest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < size && top_k_ranks_before(&heap[weakest], &heap[left])) weakest = left;
+        if (right < size && top_k_ranks_before(&heap[weakest], &heap[right])) weakest = right;
+        if (weakest == i) {
+            return;
+        }
+        TopKEntry swap = heap[i];
+        heap[i] = heap[weakest];
+        heap[weakest] = swap;
+        i = weakest;
+    }
+}
+
+static void top_k_sift_up(TopKEntry* heap, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!top_k_ranks_before(&heap[parent], &heap[i])) {
+            return;
+        }
+        TopKEntry swap = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = swap;
+        i = parent;
+    }
+}
+
+// Slots of the k best records in rank order, from one pass over the GPAs in
+// O(n log k); most records lose to the heap root on the GPA alone
+static int top_k_scan(const StudentManager* manager, int k, int* slots) {
+    TopKEntry* heap = malloc((size_t)k * sizeof(TopKEntry));
+    if (heap == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    double buffer[GPA_SCAN_BLOCK];
+    int step = gpa_scan_step(manager);
+    int size = 0;
+    for (int start = 0; start < manager->count; start += step) {
+        int n = manager->count - start < step ? manager->count - start : step;
+        const double* values = gpa_block(manager, start, n, buffer);
+        for (int i = 0; i < n; i++) {
+            if (size == k && values[i] < heap[0].gpa) {
+                continue;
+            }
+            TopKEntry entry = {values[i], student_id_at(manager, start + i), start + i};
+            if (size < k) {
+                heap[size] = entry;
+                top_k_sift_up(heap, size++);
+            } else if (top_k_ranks_before(&entry, &heap[0])) {
+                heap[0] = entry;
+                top_k_sift_down(heap, size, 0);
+            }
+        }
+    }
+    
+    // Popping the weakest entry each time fills the result from the back
+    while (size > 0) {
+        slots[size - 1] = heap[0].slot;
+        heap[0] = heap[--size];
+        top_k_sift_down(heap, size, 0);
+    }
+    free(heap);
+    return SUCCESS;
+}
+
+// Slots of the k best records read off the GPA index in O(k log n): groups of
+// equal GPA are visited from the top, each from its lowest ID upwards
+static void top_k_from_index(const StudentManager* manager, int k, int* slots) {
+    const OrderedIndex* index = &manager->gpa_index;
+    const OrderedNode* group = ordered_index_last(index);
+    int found = 0;
+    
+    while (found < k && group != NULL) {
+        double gpa = group->key;
+        const OrderedNode* first = ordered_index_lower_bound(index, gpa);
+        for (const OrderedNode* node = first; node != NULL && node->key == gpa && found < k;
+             node = ordered_index_next(index, node)) {
+            slots[found++] = id_index_find(&manager->id_index, node->id);
+        }
+        group = ordered_index_prev(index, first);
+    }
+}
+
+static int top_k_by_gpa_locked(StudentManager* manager, int k, Student* out) {
+    DEBUG_PRINT("Finding top %d students by GPA", k);
+    
+    if (manager == NULL || k < 0 || (k > 0 && out == NULL)) {
+        DEBUG_PRINT("Invalid parameters for top_k_by_gpa");
+        return ERROR_INVALID_INPUT;
+    }
+    
+    int live = live_student_count(manager);
+    if (k > live) {
+        k = live;
+    }
+    if (k == 0) {
+        return 0;
+    }
+    
+    int* slots = malloc((size_t)k * sizeof(int));
+    if (slots == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    if (manager->indexes & STUDENT_INDEX_GPA) {
+        top_k_from_index(manager, k, slots);
+    } else if (top_k_scan(manager, k, slots) != SUCCESS) {
+        free(slots);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    
+    for (int i = 0; i < k; i++) {
+        read_student(manager, slots[i], &out[i]);
+    }
+    free(slots);
+    return k;
+}
+
+int top_k_by_gpa(StudentManager* manager, int k, Student* out) {
+    lock_students_for_scan(manager);
+    int result = top_k_by_gpa_locked(manager, k, out);
+    unlock_students_shared(manager);
+    return result;
+}
+
+// Quickselect with a three-way partition, which keeps the many repeated
+// GPAs of a real roster from degrading it. Afterwards values[rank] holds
+// the value of that rank in ascending order, everything before it is no
+// larger and everything after it no smaller.
+static double select_gpa_rank(double* values, size_t n, size_t rank) {
+    size_t low = 0;
+    size_t high = n;
+    
+    while (high - low > 1) {
+        double a = values[low];
+        double b = values[low + (high - low) / 2];
+        double c = values[high - 1];
+        double pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        
+        size_t less = low, i = low, greater = high;
+        while (i < greater) {
+            double value = values[i];
+            if (value < pivot) {
+                values[i++] = values[less];
+                values[less++] = value;
+            } else if (value > pivot) {
+                values[i] = values[--greater];
+                values[greater] = value;
+            } else {
+                i++;
+            }
+        }
+        
+        if (rank < less) {
+            high = less;
+        } else if (rank >= greater) {
+            low = greater;
+        } else {
+            return pivot;
+        }
+    }
+    return values[rank];
+}
+
+static double gpa_percentile_locked(StudentManager* manager, double p) {
+    DEBUG_PRINT("Finding GPA percentile %.2f", p);
+    
+    if (manager == NULL || live_student_count(manager) == 0 || !(p >= 0.0 && p <= 100.0)) {
+        DEBUG_PRINT("No students or invalid percentile for gpa_percentile");
+        return 0.0;
+    }
+    
+    size_t n = (size_t)manager->count;
+    double* values = malloc(n * sizeof(double));
+    if (values == NULL) {
+        return 0.0;
+    }
+    int step = gpa_scan_step(manager);
+    for (int start = 0; start < manager->count; start += step) {
+        int block = manager->count - start < step ? manager->count - start : step;
+        const double* source = gpa_block(manager, start, block, values + start);
+        if (source != values + start) {
+            memcpy(values + start, source, (size_t)block * sizeof(double));
+        }
+    }
+    
+    // Linear interpolation between the two closest ranks
+    double position = p / 100.0 * (double)(n - 1);
+    size_t rank = (size_t)position;
+    double fraction = position - (double)rank;
+    double result = select_gpa_rank(values, n, rank);
+    if (fraction > 0.0 && rank + 1 < n) {
+        size_t low, high;
+        gpa_kernel_min_max(values + rank + 1, n - rank - 1, &low, &high);
+        result += fraction * (values[rank + 1 + low] - result);
+    }
+    
+    free(values);
+    DEBUG_PRINT("GPA percentile %.2f: %.2f", p, result);
+    return result;
+}
+
+double gpa_percentile(StudentManager* manager, double p) {
+    lock_students_for_scan(manager);
+    double result = gpa_percentile_locked(manager, p);
+    unlock_students_shared(manager);
+    return result;
+}
+
+// Comparison functions for sorting
+static int compare_by_id(const void* a, const void* b) {
+    const Student* student_a = (const Student*)a;
+    const Student* student_b = (const Student*)b;
+    return student_a->id - student_b->id;
+}
+
+static int compare_by_name(const void* a, const void* b) {
+    const Student* student_a = (const Student*)a;
+    const Student* student_b = (const Student*)b;
+    return strcmp(student_a->name, student_b->name);
+}
+
+static int compare_by_gpa_desc(const void* a, const void* b) {
+    const Student* student_a = (const Student*)a;
+    const Student* student_b = (const Student*)b;
+    
+    if (student_a->gpa > student_b->gpa) return -1;
+    if (student_a->gpa < student_b->gpa) return 1;
+    return 0;
+}
+
+// Sorting by keys. The sort keys of each record are encoded into one
+// fixed-width byte string whose memcmp order is the requested order: IDs as
+// 4 big-endian bytes, GPAs as 2 bytes of hundredths (or the 8 bytes of the
+// double when some GPA is off that grid), names zero-padded to the longest
+// name, each key's bytes inverted when it is descending. In the column
+// layout name lengths come from the arena handles, so names are copied
+// without scanning for their terminator. Keys of at most 4 bytes are
+// packed next to the slot in one 64-bit word; longer ones are
+// sorted 8 bytes at a time, held beside the slot, and only records sharing
+// those bytes go on to the next 8. Every pass is stable and compares
+// integers, never calling a comparator, and the records are then moved
+// once.
+#define RADIX_BITS 10
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define PACKED_KEY_BYTES 4
+#define PREFIX_KEY_BYTES 8
+#define PREFIX_INSERTION_CUTOFF 32
+
+typedef struct {
+    StudentSortKey key;
+    size_t offset;      // Position within the encoded key
+    size_t width;
+} SortKeyField;
+
+typedef struct {
+    uint64_t prefix;    // First PREFIX_KEY_BYTES of the encoded key, big-endian
+    uint32_t slot;
+} SortPrefix;
+
+// Sort n pairs (key in the high 32 bits, slot in the low 32) on the low
+// key_bits of the key; returns whichever of pairs and scratch holds the result
+static uint64_t* radix_sort_pairs(uint64_t* pairs, uint64_t* scratch, int n, int key_bits) {
+    for (int shift = 32; shift < 32 + key_bits; shift += RADIX_BITS) {
+        size_t offsets[RADIX_BUCKETS] = {0};
+        for (int i = 0; i < n; i++) {
+            offsets[(pairs[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+        // A digit shared by every key would copy the pairs unchanged
+        if (offsets[(pairs[0] >> shift) & (RADIX_BUCKETS - 1)] == (size_t)n) {
+            continue;
+        }
+        
+        size_t total = 0;
+        for (int digit = 0; digit < RADIX_BUCKETS; digit++) {
+            size_t bucket = offsets[digit];
+            offsets[digit] = total;
+            total += bucket;
+        }
+        for (int i = 0; i < n; i++) {
+            scratch[offsets[(pairs[i] >> shift) & (RADIX_BUCKETS - 1)]++] = pairs[i];
+        }
+        
+        uint64_t* swap = pairs;
+        pairs = scratch;
+        scratch = swap;
+    }
+    return pairs;
+}
+
+// LSD sort of n prefixes, skipping the digits where no bit of varying is
+// set; returns whichever of entries and scratch holds the result
+static SortPrefix* radix_sort_prefixes(SortPrefix* entries, SortPrefix* scratch, size_t n, uint64_t varying) {
+    for (int shift = 0; shift < 64 && (varying >> shift) != 0; shift += RADIX_BITS) {
+        if (((varying >> shift) & (RADIX_BUCKETS - 1)) == 0) {
+            continue;
+        }
+        
+        size_t offsets[RADIX_BUCKETS] = {0};
+        for (size_t i = 0; i < n; i++) {
+            offsets[(entries[i].prefix >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+        size_t total = 0;
+        for (int digit = 0; digit < RADIX_BUCKETS; digit++) {
+            size_t bucket = offsets[digit];
+            offsets[digit] = total;
+            total += bucket;
+        }
+        for (size_t i = 0; i < n; i++) {
+            scratch[offsets[(entries[i].prefix >> shift) & (RADIX_BUCKETS - 1)]++] = entries[i];
+        }
+        
+        SortPrefix* swap = entries;
+        entries = scratch;
+        scratch = swap;
+    }
+    return entries;
+}
+
+// GPA in hundredths, or -1 if it does not lie exactly on that grid
+static int gpa_sort_key(double gpa) {
+    int hundredths = (int)(gpa * 100.0 + 0.5);
+    return (double)hundredths / 100.0 == gpa ? hundredths : -1;
+}
+
+// Column-layout names carry their length in the arena handle
+static size_t sort_name_length(const StudentManager* manager, int slot) {
+    return manager->layout == STUDENT_LAYOUT_COLUMNS
+        ? name_arena_length(&manager->names, manager->name_offsets[slot])
+        : strlen(manager->students[slot].name);
+}
+
+// Lay out the encoded key; returns its width in bytes
+static size_t plan_sort_key(const StudentManager* manager, const StudentSortKey* keys,
+                            int key_count, SortKeyField* fields) {
+    size_t width = 0;
+    for (int k = 0; k < key_count; k++) {
+        fields[k].key = keys[k];
+        fields[k].offset = width;
+        fields[k].width = 4;
+        
+        if (keys[k].field == STUDENT_SORT_GPA) {
+            fields[k].width = 2;
+            for (int i = 0; i < manager->count; i++) {
+                if (gpa_sort_key(student_gpa_at(manager, i)) < 0) {
+                    fields[k].width = 8;
+                    break;
+                }
+            }
+        } else if (keys[k].field == STUDENT_SORT_NAME) {
+            fields[k].width = 0;
+            for (int i = 0; i < manager->count; i++) {
+                size_t length = sort_name_length(manager, i);
+                if (length > fields[k].width) {
+                    fields[k].width = length;
+                }
+            }
+        }
+        width += fields[k].width;
+    }
+    return width;
+}
+
+static void store_big_endian(unsigned char* bytes, uint64_t value, size_t width) {
+    for (size_t i = width; i-- > 0;) {
+        bytes[i] = (unsigned char)value;
+        value >>= 8;
+    }
+}
+
+static void encode_sort_key(const StudentManager* manager, int slot, const SortKeyField* fields,
+                            int field_count, unsigned char* key) {
+    for (int k = 0; k < field_count; k++) {
+        unsigned char* bytes = key + fields[k].offset;
+        size_t width = fields[k].width;
+        
+        if (fields[k].key.field == STUDENT_SORT_ID) {
+            store_big_endian(bytes, (uint32_t)student_id_at(manager, slot), width);
+        } else if (fields[k].key.field == STUDENT_SORT_GPA) {
+            double gpa = student_gpa_at(manager, slot) + 0.0;   // -0.0 sorts as 0.0
+            if (width == 2) {
+                store_big_endian(bytes, (uint64_t)gpa_sort_key(gpa), width);
+            } else {
+                // Flip the sign bit of positive doubles and every bit of
+                // negative ones, so the bits order as unsigned integers
+                uint64_t bits;
+                memcpy(&bits, &gpa, sizeof(bits));
+                bits ^= (bits >> 63) ? UINT64_MAX : UINT64_C(1) << 63;
+                store_big_endian(bytes, bits, width);
+            }
+        } else {
+            size_t length = sort_name_length(manager, slot);
+            memcpy(bytes, student_name_at(manager, slot), length);
+            memset(bytes + length, 0, width - length);
+        }
+        
+        if (fields[k].key.descending) {
+            for (size_t i = 0; i < width; i++) {
+                bytes[i] = (unsigned char)~bytes[i];
+            }
+        }
+    }
+}
+
+// First bytes of an encoded key as a big-endian integer, zero-filled
+static uint64_t load_big_endian(const unsigned char* bytes, size_t width, size_t count) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; i++) {
+        value = value << 8 | (i < width ? bytes[i] : 0);
     }
+    return value;
 }
 
-// Student management functions
-int add_student(StudentManager* manager, int id, const char* name, double gpa) {
-    DEBUG_PRINT("Adding student: ID=%d, Name=%s, GPA=%.2f", id, name, gpa);
-    
-    if (manager == NULL || name == NULL) {
-        DEBUG_PRINT("Invalid parameters for add_student");
-        return ERROR_INVALID_INPUT;
-    }
-    
-    if (manager->count >= manager->capacity) {
-        DEBUG_PRINT("Student manager is full");
+// Keys of up to PACKED_KEY_BYTES: (key, slot) words through the LSD sort,
+// on as many bits as the keys actually differ in
+static int sort_order_packed(const StudentManager* manager, const SortKeyField* fields,
+                             int field_count, size_t width, int* order) {
+    int n = manager->count;
+    uint64_t* pairs = malloc((size_t)n * sizeof(uint64_t));
+    uint64_t* scratch = malloc((size_t)n * sizeof(uint64_t));
+    if (pairs == NULL || scratch == NULL) {
+        free(pairs);
+        free(scratch);
         return ERROR_MEMORY_ALLOCATION;
     }
     
-    if (!is_valid_student_id(id)) {
-        DEBUG_PRINT("Invalid student ID: %d", id);
-        return ERROR_INVALID_INPUT;
+    uint64_t varying = 0;
+    for (int i = 0; i < n; i++) {
+        unsigned char bytes[PACKED_KEY_BYTES];
+        encode_sort_key(manager, i, fields, field_count, bytes);
+        pairs[i] = load_big_endian(bytes, width, width) << 32 | (uint32_t)i;
+        varying |= (pairs[i] ^ pairs[0]) >> 32;
     }
-    
-    if (!is_valid_gpa(gpa)) {
-        DEBUG_PRINT("Invalid GPA: %.2f", gpa);
-        return ERROR_INVALID_INPUT;
+    int key_bits = 0;
+    while (varying >> key_bits != 0) {
+        key_bits++;
     }
-    
-    // Check if student already exists
-    if (find_student(manager, id) != NULL) {
-        DEBUG_PRINT("Student with ID %d already exists", id);
-        return ERROR_STUDENT_EXISTS;
+    const uint64_t* sorted = radix_sort_pairs(pairs, scratch, n, key_bits);
+    for (int i = 0; i < n; i++) {
+        order[i] = (int)(uint32_t)sorted[i];
     }
     
-    // Add new student
-    Student* new_student = &manager->students[manager->count];
-    new_student->id = id;
-    strncpy(new_student->name, name, MAX_NAME_LENGTH - 1);
-    new_student->name[MAX_NAME_LENGTH - 1] = '\0';  // Ensure null termination
-    new_student->gpa = gpa;
-    
-    manager->count++;
-    DEBUG_PRINT("Student added successfully. Total students: %d", manager->count);
+    free(pairs);
+    free(scratch);
     return SUCCESS;
 }
 
-int remove_student(StudentManager* manager, int id) {
-    DEBUG_PRINT("Removing student with ID: %d", id);
-    
-    if (manager == NULL) {
-        DEBUG_PRINT("Invalid manager parameter");
-        return ERROR_INVALID_INPUT;
+// Order n entries whose encoded keys agree on their first depth bytes by
+// the next PREFIX_KEY_BYTES, then each run that ties on those by the rest
+static void sort_prefix_run(SortPrefix* entries, SortPrefix* scratch, size_t n,
+                            const unsigned char* encoded, size_t width, size_t depth) {
+    uint64_t varying = 0;
+    for (size_t i = 0; i < n; i++) {
+        entries[i].prefix = load_big_endian(encoded + entries[i].slot * width + depth,
+                                            width - depth, PREFIX_KEY_BYTES);
+        varying |= entries[i].prefix ^ entries[0].prefix;
     }
     
-    // Find student index
-    int index = -1;
-    for (int i = 0; i < manager->count; i++) {
-        if (manager->students[i].id == id) {
-            index = i;
-            break;
+    if (n <= PREFIX_INSERTION_CUTOFF) {
+        // Moving an entry only past greater ones keeps ties in order
+        for (size_t i = 1; i < n; i++) {
+            SortPrefix entry = entries[i];
+            size_t j = i;
+            while (j > 0 && entries[j - 1].prefix > entry.prefix) {
+                entries[j] = entries[j - 1];
+                j--;
+            }
+            entries[j] = entry;
         }
+    } else if (radix_sort_prefixes(entries, scratch, n, varying) != entries) {
+        memcpy(entries, scratch, n * sizeof(SortPrefix));
     }
     
-    if (index == -1) {
-        DEBUG_PRINT("Student with ID %d not found", id);
-        return ERROR_STUDENT_NOT_FOUND;
+    depth += PREFIX_KEY_BYTES;
+    if (depth >= width) {
+        return;
     }
-    
-    // Shift remaining students
-    for (int i = index; i < manager->count - 1; i++) {
-        manager->students[i] = manager->students[i + 1];
+    size_t start = 0;
+    while (start < n) {
+        size_t end = start + 1;
+        while (end < n && entries[end].prefix == entries[start].prefix) {
+            end++;
+        }
+        if (end - start > 1) {
+            sort_prefix_run(entries + start, scratch + start, end - start, encoded, width, depth);
+        }
+        start = end;
     }
-    
-    manager->count--;
-    DEBUG_PRINT("Student removed successfully. Total students: %d", manager->count);
-    return SUCCESS;
 }
 
-Student* find_student(StudentManager* manager, int id) {
-    DEBUG_PRINT("Finding student with ID: %d", id);
-    
-    if (manager == NULL) {
-        DEBUG_PRINT("Invalid manager parameter");
-        return NULL;
+// Longer keys: encoded back to back, then sorted through their prefixes
+static int sort_order_bytes(const StudentManager* manager, const SortKeyField* fields,
+                            int field_count, size_t width, int* order) {
+    size_t n = (size_t)manager->count;
+    unsigned char* encoded = malloc(n * width);
+    SortPrefix* entries = malloc(n * sizeof(SortPrefix));
+    SortPrefix* scratch = malloc(n * sizeof(SortPrefix));
+    if (encoded == NULL || entries == NULL || scratch == NULL) {
+        free(encoded);
+        free(entries);
+        free(scratch);
+        return ERROR_MEMORY_ALLOCATION;
     }
     
-    for (int i = 0; i < manager->count; i++) {
-        if (manager->students[i].id == id) {
-            DEBUG_PRINT("Student found at index %d", i);
-            return &manager->students[i];
-        }
+    for (size_t i = 0; i < n; i++) {
+        encode_sort_key(manager, (int)i, fields, field_count, encoded + i * width);
+        entries[i].slot = (uint32_t)i;
+    }
+    sort_prefix_run(entries, scratch, n, encoded, width, 0);
+    for (size_t i = 0; i < n; i++) {
+        order[i] = (int)entries[i].slot;
     }
     
-    DEBUG_PRINT("Student with ID %d not found", id);
-    return NULL;
+    free(encoded);
+    free(entries);
+    free(scratch);
+    return SUCCESS;
 }
 
-int update_student_gpa(StudentManager* manager, int id, double new_gpa) {
-    DEBUG_PRINT("Updating GPA for student ID %d to %.2f", id, new_gpa);
+static int sort_students_locked(StudentManager* manager, const StudentSortKey* keys, int key_count) {
+    DEBUG_PRINT("Sorting students by %d key(s)", key_count);
     
-    if (manager == NULL) {
-        DEBUG_PRINT("Invalid manager parameter");
+    if (manager == NULL || keys == NULL || key_count < 1 || key_count > MAX_STUDENT_SORT_KEYS) {
+        DEBUG_PRINT("Invalid parameters for sort_students");
         return ERROR_INVALID_INPUT;
     }
+    for (int k = 0; k < key_count; k++) {
+        if (keys[k].field != STUDENT_SORT_ID && keys[k].field != STUDENT_SORT_NAME &&
+            keys[k].field != STUDENT_SORT_GPA) {
+            DEBUG_PRINT("Unknown sort field: %d", (int)keys[k].field);
+            return ERROR_INVALID_INPUT;
+        }
+    }
     
-    if (!is_valid_gpa(new_gpa)) {
-        DEBUG_PRINT("Invalid GPA: %.2f", new_gpa);
-        return ERROR_INVALID_INPUT;
+    purge_tombstones(manager);
+    if (manager->count <= 1) {
+        return SUCCESS;
     }
     
-    Student* student = find_student(manager, id);
-    if (student == NULL) {
-        DEBUG_PRINT("Student with ID %d not found", id);
-        return ERROR_STUDENT_NOT_FOUND;
+    SortKeyField fields[MAX_STUDENT_SORT_KEYS];
+    size_t width = plan_sort_key(manager, keys, key_count, fields);
+    int* order = malloc((size_t)manager->count * sizeof(int));
+    if (order == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
     }
     
-    student->gpa = new_gpa;
-    DEBUG_PRINT("GPA updated to %.2f", new_gpa);
-    return SUCCESS;
-}
-
-int get_student_count(StudentManager* manager) {
-    if (manager == NULL) {
-        DEBUG_PRINT("Invalid manager parameter");
-        return 0;
+    int result = width <= PACKED_KEY_BYTES
+        ? sort_order_packed(manager, fields, key_count, width, order)
+        : sort_order_bytes(manager, fields, key_count, width, order);
+    if (result == SUCCESS) {
+        result = permute_students(manager, order);
     }
+    free(order);
     
-    return manager->count;
+    if (result != SUCCESS) {
+        DEBUG_PRINT("Not enough memory to sort students");
+    }
+    return result;
 }
 
-// Display functions
-void display_student(const Student* student) {
-    if (student == NULL) {
-        printf("Invalid student\n");
-        return;
-    }
-    
-    printf("ID: %d, Name: %-20s, GPA: %.2f\n", 
-           student->id, student->name, student->gpa);
+int sort_students(StudentManager* manager, const StudentSortKey* keys, int key_count) {
+    lock_students_exclusive(manager);
+    int result = sort_students_locked(manager, keys, key_count);
+    unlock_students_exclusive(manager);
+    return result;
 }
 
-void display_all_students(StudentManager* manager) {
-    DEBUG_PRINT("Displaying all students");
-    
-    if (manager == NULL) {
-        printf("Invalid student manager\n");
-        return;
-    }
-    
-    if (manager->count == 0) {
-        printf("No students in the system\n");
+// Sorting functions
+// Sort by one key. If the keys do not fit in memory, rows fall back to an
+// in-place qsort, which orders them correctly but may reorder ties.
+static void sort_students_by_key_locked(StudentManager* manager, StudentSortField field, int descending,
+                                        int (*compare)(const void*, const void*)) {
+    if (manager == NULL || live_student_count(manager) <= 1) {
+        DEBUG_PRINT("No sorting needed");
         return;
     }
     
-    printf("%-5s %-20s %-5s\n", "ID", "Name", "GPA");
-    printf("%-5s %-20s %-5s\n", "---", "--------------------", "-----");
-    
-    for (int i = 0; i < manager->count; i++) {
-        display_student(&manager->students[i]);
+    StudentSortKey key = {field, descending};
+    if (sort_students_locked(manager, &key, 1) != SUCCESS && manager->layout == STUDENT_LAYOUT_ROWS) {
+        qsort(manager->students, manager->count, sizeof(Student), compare);
+        reindex_students(manager);
     }
 }
 
-// Statistics functions
-double calculate_average_gpa(StudentManager* manager) {
-    DEBUG_PRINT("Calculating average GPA");
-    
-    if (manager == NULL || manager->count == 0) {
-        DEBUG_PRINT("No students for GPA calculation");
-        return 0.0;
-    }
-    
-    double total = 0.0;
-    for (int i = 0; i < manager->count; i++) {
-        total += manager->students[i].gpa;
-    }
-    
-    double average = total / manager->count;
-    DEBUG_PRINT("Average GPA: %.2f", average);
-    return average;
+void sort_students_by_id(StudentManager* manager) {
+    lock_students_exclusive(manager);
+    sort_students_by_key_locked(manager, STUDENT_SORT_ID, 0, compare_by_id);
+    unlock_students_exclusive(manager);
 }
 
-double calculate_highest_gpa(StudentManager* manager) {
-    DEBUG_PRINT("Finding highest GPA");
-    
-    if (manager == NULL || manager->count == 0) {
-        DEBUG_PRINT("No students for highest GPA calculation");
-        return 0.0;
-    }
-    
-    double highest = manager->students[0].gpa;
-    for (int i = 1; i < manager->count; i++) {
-        if (manager->students[i].gpa > highest) {
-            highest = manager->students[i].gpa;
-        }
-    }
-    
-    DEBUG_PRINT("Highest GPA: %.2f", highest);
-    return highest;
+void sort_students_by_name(StudentManager* manager) {
+    lock_students_exclusive(manager);
+    sort_students_by_key_locked(manager, STUDENT_SORT_NAME, 0, compare_by_name);
+    unlock_students_exclusive(manager);
 }
 
-double calculate_lowest_gpa(StudentManager* manager) {
-    DEBUG_PRINT("Finding lowest GPA");
-    
-    if (manager == NULL || manager->count == 0) {
-        DEBUG_PRINT("No students for lowest GPA calculation");
-        return 0.0;
-    }
-    
-    double lowest = manager->students[0].gpa;
-    for (int i = 1; i < manager->count; i++) {
-        if (manager->students[i].gpa < lowest) {
-            lowest = manager->students[i].gpa;
-        }
-    }
-    
-    DEBUG_PRINT("Lowest GPA: %.2f", lowest);
-    return lowest;
+void sort_students_by_gpa(StudentManager* manager) {
+    lock_students_exclusive(manager);
+    sort_students_by_key_locked(manager, STUDENT_SORT_GPA, 1, compare_by_gpa_desc);
+    unlock_students_exclusive(manager);
 }
 
-Student* find_student_with_highest_gpa(StudentManager* manager) {
-    DEBUG_PRINT("Finding student with highest GPA");
-    
-    if (manager == NULL || manager->count == 0) {
-        DEBUG_PRINT("No students available");
-        return NULL;
-    }
-    
-    Student* highest_student = &manager->students[0];
-    for (int i = 1; i < manager->count; i++) {
-        if (manager->students[i].gpa > highest_student->gpa) {
-            highest_student = &manager->students[i];
-        }
+// Ordered views
+static int students_by_gpa_locked(StudentManager* manager, int descending, StudentCursor* cursor) {
+    if (manager == NULL || cursor == NULL ||
+        !(manager->indexes & STUDENT_INDEX_GPA)) {
+        return ERROR_INVALID_INPUT;
     }
     
-    DEBUG_PRINT("Student with highest GPA: %s (%.2f)", 
-                highest_student->name, highest_student->gpa);
-    return highest_student;
+    cursor->manager = manager;
+    cursor->generation = manager->generation;
+    cursor->position = descending ? ordered_index_last(&manager->gpa_index)
+                                  : ordered_index_first(&manager->gpa_index);
+    cursor->view = descending ? STUDENT_VIEW_GPA_DESCENDING : STUDENT_VIEW_GPA;
+    cursor->gpa_limit = INFINITY;
+    cursor->prefix[0] = '\0';
+    cursor->prefix_length = 0;
+    return SUCCESS;
 }
 
-Student* find_student_with_lowest_gpa(StudentManager* manager) {
-    DEBUG_PRINT("Finding student with lowest GPA");
-    
-    if (manager == NULL || manager->count == 0) {
-        DEBUG_PRINT("No students available");
-        return NULL;
-    }
-    
-    Student* lowest_student = &manager->students[0];
-    for (int i = 1; i < manager->count; i++) {
-        if (manager->students[i].gpa < lowest_student->gpa) {
-            lowest_student = &manager->students[i];
-        }
+int students_by_gpa(StudentManager* manager, int descending, StudentCursor* cursor) {
+    lock_students_shared(manager);
+    int result = students_by_gpa_locked(manager, descending, cursor);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static int students_by_name_locked(StudentManager* manager, StudentCursor* cursor) {
+    if (manager == NULL || cursor == NULL ||
+        !(manager->indexes & STUDENT_INDEX_NAME)) {
+        return ERROR_INVALID_INPUT;
     }
     
-    DEBUG_PRINT("Student with lowest GPA: %s (%.2f)", 
-                lowest_student->name, lowest_student->gpa);
-    return lowest_student;
+    cursor->manager = manager;
+    cursor->generation = manager->generation;
+    cursor->position = ordered_index_first(&manager->name_index);
+    cursor->view = STUDENT_VIEW_NAME;
+    cursor->gpa_limit = INFINITY;
+    cursor->prefix[0] = '\0';
+    cursor->prefix_length = 0;
+    return SUCCESS;
 }
 
-// Comparison functions for sorting
-static int compare_by_id(const void* a, const void* b) {
-    const Student* student_a = (const Student*)a;
-    const Student* student_b = (const Student*)b;
-    return student_a->id - student_b->id;
+int students_by_name(StudentManager* manager, StudentCursor* cursor) {
+    lock_students_shared(manager);
+    int result = students_by_name_locked(manager, cursor);
+    unlock_students_shared(manager);
+    return result;
 }
 
-static int compare_by_name(const void* a, const void* b) {
-    const Student* student_a = (const Student*)a;
-    const Student* student_b = (const Student*)b;
-    return strcmp(student_a->name, student_b->name);
+static int students_in_gpa_range_locked(StudentManager* manager, double min_gpa, double max_gpa,
+                                        StudentCursor* cursor) {
+    if (manager == NULL || cursor == NULL || isnan(min_gpa) || isnan(max_gpa) ||
+        !(manager->indexes & STUDENT_INDEX_GPA)) {
+        return ERROR_INVALID_INPUT;
+    }
+    
+    cursor->manager = manager;
+    cursor->generation = manager->generation;
+    cursor->position = ordered_index_lower_bound(&manager->gpa_index, min_gpa);
+    cursor->view = STUDENT_VIEW_GPA;
+    cursor->gpa_limit = max_gpa;
+    cursor->prefix[0] = '\0';
+    cursor->prefix_length = 0;
+    return SUCCESS;
 }
 
-static int compare_by_gpa_desc(const void* a, const void* b) {
-    const Student* student_a = (const Student*)a;
-    const Student* student_b = (const Student*)b;
-    
-    if (student_a->gpa > student_b->gpa) return -1;
-    if (student_a->gpa < student_b->gpa) return 1;
-    return 0;
+int students_in_gpa_range(StudentManager* manager, double min_gpa, double max_gpa,
+                          StudentCursor* cursor) {
+    lock_students_shared(manager);
+    int result = students_in_gpa_range_locked(manager, min_gpa, max_gpa, cursor);
+    unlock_students_shared(manager);
+    return result;
 }
 
-// Sorting functions
-void sort_students_by_id(StudentManager* manager) {
-    DEBUG_PRINT("Sorting students by ID");
+static int students_with_name_prefix_locked(StudentManager* manager, const char* prefix, StudentCursor* cursor) {
+    if (manager == NULL || prefix == NULL || cursor == NULL ||
+        !(manager->indexes & STUDENT_INDEX_NAME)) {
+        return ERROR_INVALID_INPUT;
+    }
     
-    if (manager == NULL || manager->count <= 1) {
-        DEBUG_PRINT("No sorting needed");
-        return;
+    size_t length = strlen(prefix);
+    if (length >= MAX_NAME_LENGTH) {
+        // No stored name can be that long, so the view is empty
+        length = 0;
+        cursor->position = NULL;
+    } else {
+        cursor->position = ordered_index_lower_bound_text(&manager->name_index, prefix);
     }
     
-    qsort(manager->students, manager->count, sizeof(Student), compare_by_id);
-    DEBUG_PRINT("Students sorted by ID");
+    cursor->manager = manager;
+    cursor->generation = manager->generation;
+    cursor->view = STUDENT_VIEW_NAME;
+    cursor->gpa_limit = INFINITY;
+    memcpy(cursor->prefix, prefix, length);
+    cursor->prefix[length] = '\0';
+    cursor->prefix_length = length;
+    return SUCCESS;
 }
 
-void sort_students_by_name(StudentManager* manager) {
-    DEBUG_PRINT("Sorting students by name");
-    
-    if (manager == NULL || manager->count <= 1) {
-        DEBUG_PRINT("No sorting needed");
-        return;
-    }
-    
-    qsort(manager->students, manager->count, sizeof(Student), compare_by_name);
-    DEBUG_PRINT("Students sorted by name");
+int students_with_name_prefix(StudentManager* manager, const char* prefix, StudentCursor* cursor) {
+    lock_students_shared(manager);
+    int result = students_with_name_prefix_locked(manager, prefix, cursor);
+    unlock_students_shared(manager);
+    return result;
 }
 
-void sort_students_by_gpa(StudentManager* manager) {
-    DEBUG_PRINT("Sorting students by GPA (descending)");
+static Student* student_cursor_next_locked(StudentCursor* cursor) {
+    if (cursor == NULL || cursor->position == NULL) {
+        return NULL;
+    }
     
-    if (manager == NULL || manager->count <= 1) {
-        DEBUG_PRINT("No sorting needed");
-        return;
+    const OrderedNode* node = cursor->position;
+    StudentManager* manager = cursor->manager;
+    
+    // The node may be gone once the manager has been modified
+    if (cursor->generation != manager->generation) {
+        cursor->position = NULL;
+        return NULL;
+    }
+    
+    // Ascending views end at the first entry past their upper bound
+    if (cursor->view == STUDENT_VIEW_GPA && node->key > cursor->gpa_limit) {
+        cursor->position = NULL;
+        return NULL;
+    }
+    if (cursor->view == STUDENT_VIEW_NAME &&
+        strncmp(node->text, cursor->prefix, cursor->prefix_length) != 0) {
+        cursor->position = NULL;
+        return NULL;
     }
     
-    qsort(manager->students, manager->count, sizeof(Student), compare_by_gpa_desc);
-    DEBUG_PRINT("Students sorted by GPA");
+    cursor->position = cursor->view == STUDENT_VIEW_GPA_DESCENDING ? node->prev : node->next[0];
+    return student_at(manager, id_index_find(&manager->id_index, node->id));
+}
+
+Student* student_cursor_next(StudentCursor* cursor) {
+    StudentManager* manager = cursor != NULL ? cursor->manager : NULL;
+    lock_students_shared(manager);
+    Student* result = student_cursor_next_locked(cursor);
+    unlock_students_shared(manager);
+    return result;
 }
 
 // File I/O functions
-int save_students_to_file(StudentManager* manager, const char* filename) {
+int save_students_to_file_locked(StudentManager* manager, const char* filename) {
     DEBUG_PRINT("Saving students to file: %s", filename);
     
     if (manager == NULL || filename == NULL) {
@@ -372,83 +2331,66 @@ int save_students_to_file(StudentManager* manager, const char* filename) {
     // Write student data
     for (int i = 0; i < manager->count; i++) {
         fprintf(file, "%d,%s,%.2f\n", 
-                manager->students[i].id,
-                manager->students[i].name,
-                manager->students[i].gpa);
+                student_id_at(manager, i),
+                student_name_at(manager, i),
+                student_gpa_at(manager, i));
+    }
+    
+    // A short write (e.g. a full disk) sets the error flag, and buffered
+    // data can still fail to land when the file is synced or closed
+    int result = ferror(file) ? ERROR_FILE_IO : sync_file(file);
+    if (fclose(file) != 0 && result == SUCCESS) {
+        result = ERROR_FILE_IO;
+    }
+    if (result != SUCCESS) {
+        DEBUG_PRINT("Failed to write students to file: %s", filename);
+        return result;
     }
     
-    fclose(file);
     DEBUG_PRINT("Successfully saved %d students to file", manager->count);
     return SUCCESS;
 }
 
+int save_students_to_file(StudentManager* manager, const char* filename) {
+    lock_students_for_scan(manager);
+    int result = save_students_to_file_locked(manager, filename);
+    unlock_students_shared(manager);
+    return result;
+}
+
 int load_students_from_file(StudentManager* manager, const char* filename) {
     DEBUG_PRINT("Loading students from file: %s", filename);
     
-    if (manager == NULL || filename == NULL) {
-        DEBUG_PRINT("Invalid parameters for load_students_from_file");
-        return ERROR_INVALID_INPUT;
-    }
-    
-    FILE* file = fopen(filename, "r");
-    if (file == NULL) {
-        DEBUG_PRINT("Failed to open file for reading: %s", filename);
-        return ERROR_FILE_NOT_FOUND;
-    }
-    
-    char line[256];
-    
-    // Skip header lines
-    fgets(line, sizeof(line), file);  // Skip comment line 1
-    fgets(line, sizeof(line), file);  // Skip comment line 2
-    
-    // Read number of students
-    int count;
-    if (fscanf(file, "%d", &count) != 1) {
-        DEBUG_PRINT("Failed to read student count from file");
-        fclose(file);
-        return ERROR_INVALID_INPUT;
-    }
-    
-    DEBUG_PRINT("Loading %d students from file", count);
-    
-    // Clear existing students
-    manager->count = 0;
-    
-    // Read student data
-    for (int i = 0; i < count && i < MAX_STUDENTS; i++) {
-        int id;
-        char name[MAX_NAME_LENGTH];
-        double gpa;
-        
-        if (fscanf(file, "%d,%49[^,],%lf", &id, name, &gpa) == 3) {
-            if (add_student(manager, id, name, gpa) != SUCCESS) {
-                DEBUG_PRINT("Failed to add student during file loading");
-            }
-        } else {
-            DEBUG_PRINT("Failed to parse student data at line %d", i + 4);
-        }
-    }
-    
-    fclose(file);
-    DEBUG_PRINT("Successfully loaded %d students from file", manager->count);
-    return SUCCESS;
+    // The chunked loader keeps the original format rules and error codes
+    // and only spreads the parsing across threads for large files
+    return load_students_from_file_parallel(manager, filename, 0);
 }
 
 // Utility functions
-void clear_all_students(StudentManager* manager) {
+void clear_all_students_locked(StudentManager* manager) {
     DEBUG_PRINT("Clearing all students");
     
     if (manager != NULL) {
         manager->count = 0;
+        manager->tombstones = 0;
+        id_index_clear(&manager->id_index);
+        name_arena_clear(&manager->names);
+        reset_statistics(manager);
+        journal_log_clear(manager);
         DEBUG_PRINT("All students cleared");
     }
 }
 
+void clear_all_students(StudentManager* manager) {
+    lock_students_exclusive(manager);
+    clear_all_students_locked(manager);
+    unlock_students_exclusive(manager);
+}
+
 int is_valid_gpa(double gpa) {
     return (gpa >= MIN_GPA && gpa <= MAX_GPA);
 }
 
 int is_valid_student_id(int id) {
-    return (id > 0 && id <= 999999);  // Reasonable range for student IDs
+    return (id > 0 && id <= MAX_STUDENT_ID);  // Reasonable range for student IDs
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef STUDENT_MANAGER_H
 #define STUDENT_MANAGER_H
 
+#include <stdint.h>
 #include "config.h"
 
 // Student structure
@@ -13,17 +14,116 @@ typedef struct {
 // Student manager structure (opaque)
 typedef struct StudentManager StudentManager;
 
+// Record storage layout. ROWS keeps each Student contiguous; COLUMNS keeps
+// IDs, GPAs and names in separate arrays (names in a string arena), so scans
+// and aggregates read only the fields they use.
+typedef enum {
+    STUDENT_LAYOUT_ROWS,
+    STUDENT_LAYOUT_COLUMNS
+} StudentLayout;
+
+// Outcome of add_students_batch. error_bitmap is optional; when set it must
+// hold (n + 63) / 64 words and bit i is set if row i was rejected.
+typedef struct {
+    int added;
+    int invalid;        // Rows with an out-of-range ID or GPA
+    int duplicates;     // Rows whose ID already exists or repeats in the batch
+    uint64_t* error_bitmap;
+} StudentBatchReport;
+
+// How remove_student and remove_students_batch close the gap a record
+// leaves behind. SHIFT (the default) keeps insertion order at O(n) per
+// removal; SWAP moves the last record into the gap in O(1) but reorders;
+// TOMBSTONE marks the slot in O(1) and purges marked slots in one pass once
+// they make up half of the array, or before any full scan.
+typedef enum {
+    STUDENT_REMOVE_SHIFT,
+    STUDENT_REMOVE_SWAP,
+    STUDENT_REMOVE_TOMBSTONE
+} StudentRemovalMode;
+
+// Secondary indexes, both maintained by default. The GPA index answers
+// highest/lowest GPA queries in O(log n) and backs the GPA views; without it
+// those statistics scan the GPAs with vectorized kernels instead. The name
+// index backs the name views. Dropping an index makes inserts and updates
+// cheaper and saves memory.
+#define STUDENT_INDEX_GPA  0x1
+#define STUDENT_INDEX_NAME 0x2
+
+// Cursor over an ordered view of the roster, backed by the GPA or name
+// index. Views are read in place: creating or advancing a cursor never moves
+// records. Any modification of the manager ends open cursors, which then
+// yield NULL.
+typedef enum {
+    STUDENT_VIEW_GPA,               // Ascending GPA, ties by ascending ID
+    STUDENT_VIEW_GPA_DESCENDING,    // Descending GPA, ties by descending ID
+    STUDENT_VIEW_NAME               // Ascending name (strcmp), ties by ID
+} StudentView;
+
+typedef struct {
+    StudentManager* manager;
+    const void* position;           // Next index entry to visit
+    StudentView view;
+    double gpa_limit;               // Upper bound of a GPA range view
+    char prefix[MAX_NAME_LENGTH];   // Required prefix of a name view
+    size_t prefix_length;
+    unsigned int generation;        // Manager state the cursor was opened on
+} StudentCursor;
+
 // Constructor and destructor
 StudentManager* create_student_manager(void);
+StudentManager* create_student_manager_with_capacity(int capacity_hint);
+StudentManager* create_student_manager_with_layout(StudentLayout layout, int capacity_hint);
 void destroy_student_manager(StudentManager* manager);
 
+// Storage management
+// Records live in heap arrays that grow geometrically, so any Student*
+// handed out by the manager is invalidated by add, remove, sort or shrink.
+// In the column layout and in thread-safe mode a returned Student* points
+// at one of a few per-thread copies that later calls recycle; writes through
+// it are not stored.
+// Use get_student for a copy and update_student_gpa to modify.
+StudentLayout get_student_layout(StudentManager* manager);
+int get_student_capacity(StudentManager* manager);
+int shrink_student_manager_to_fit(StudentManager* manager);
+int set_student_indexes(StudentManager* manager, int indexes);
+int get_student_indexes(StudentManager* manager);
+int set_student_removal_mode(StudentManager* manager, StudentRemovalMode mode);
+StudentRemovalMode get_student_removal_mode(StudentManager* manager);
+int compact_student_storage(StudentManager* manager);
+// Column layout only: store each distinct name once, however many students
+// share it. The fixed part of a column record is then 16 bytes (ID, GPA and
+// a 4-byte name handle) plus one shared copy of the name.
+int set_student_name_interning(StudentManager* manager, int enabled);
+int get_student_name_interning(StudentManager* manager);
+
+// Thread safety
+// In thread-safe mode every function below takes a reader-writer lock, so
+// lookups, statistics, views and saves run concurrently with each other
+// while modifications run one at a time. Enable it before the manager is
+// shared between threads; the setter itself is not synchronized.
+int set_student_thread_safe(StudentManager* manager, int enabled);
+int get_student_thread_safe(StudentManager* manager);
+
 // Student management functions
 int add_student(StudentManager* manager, int id, const char* name, double gpa);
 int remove_student(StudentManager* manager, int id);
 Student* find_student(StudentManager* manager, int id);
+int get_student(StudentManager* manager, int id, Student* student);
 int update_student_gpa(StudentManager* manager, int id, double new_gpa);
 int get_student_count(StudentManager* manager);
 
+// Bulk insert: validates, de-duplicates and appends n records in a few
+// linear passes. Rejected rows are skipped and reported; the first
+// occurrence of a repeated ID wins, exactly as with repeated add_student.
+int add_students_batch(StudentManager* manager, const Student* students, int n,
+                       StudentBatchReport* report);
+
+// Bulk removal: every listed ID that exists is removed, the rest are
+// ignored; *removed (optional) receives the number removed. In SHIFT mode
+// the survivors are compacted in a single pass rather than once per ID.
+int remove_students_batch(StudentManager* manager, const int* ids, int n, int* removed);
+
 // Display functions
 void display_student(const Student* student);
 void display_all_students(StudentManager* manager);
@@ -34,13 +134,65 @@ double calculate_highest_gpa(StudentManager* manager);
 double calculate_lowest_gpa(StudentManager* manager);
 Student* find_student_with_highest_gpa(StudentManager* manager);
 Student* find_student_with_lowest_gpa(StudentManager* manager);
+int count_students_in_gpa_range(StudentManager* manager, double min_gpa, double max_gpa);
+// Counts per equal-width bucket over [MIN_GPA, MAX_GPA]; MAX_GPA falls in
+// the last bucket
+int calculate_gpa_histogram(StudentManager* manager, int buckets, int* counts);
+// The k highest GPAs, best first and ties to the lower ID, copied into out
+// (room for k records); returns how many were written, fewer than k only if
+// the roster is smaller. O(k log n) with the GPA index, else O(n log k).
+int top_k_by_gpa(StudentManager* manager, int k, Student* out);
+// GPA at percentile p in [0, 100], interpolating linearly between the two
+// closest ranks (p = 50 is the median); 0.0 if empty or p is out of range.
+// Expected O(n) via quickselect on a copy of the GPAs.
+double gpa_percentile(StudentManager* manager, double p);
 
 // Sorting functions
+// Sorts are stable: records with equal keys keep their current order.
+// sort_students orders by up to MAX_STUDENT_SORT_KEYS keys, most
+// significant first; GPA descending, then name ascending, is
+//
+//   StudentSortKey keys[] = {{STUDENT_SORT_GPA, 1}, {STUDENT_SORT_NAME, 0}};
+//   sort_students(manager, keys, 2);
+//
+// Names compare as with strcmp. Every record's keys are encoded into one
+// compact byte string, the strings are radix-sorted and the records are
+// then moved once. Returns ERROR_INVALID_INPUT for a bad key list, or
+// ERROR_MEMORY_ALLOCATION with the order unchanged. sort_students_by_id,
+// _by_name and _by_gpa (descending) are single-key shorthands for it.
+// Prefer the ordered views below, which move nothing.
+typedef enum {
+    STUDENT_SORT_ID,
+    STUDENT_SORT_NAME,
+    STUDENT_SORT_GPA
+} StudentSortField;
+
+typedef struct {
+    StudentSortField field;
+    int descending;
+} StudentSortKey;
+
+#define MAX_STUDENT_SORT_KEYS 3
+
+int sort_students(StudentManager* manager, const StudentSortKey* keys, int key_count);
 void sort_students_by_id(StudentManager* manager);
 void sort_students_by_name(StudentManager* manager);
 void sort_students_by_gpa(StudentManager* manager);
 
-// File I/O functions
+// Ordered views
+// Each initializes *cursor and returns SUCCESS, or ERROR_INVALID_INPUT if
+// the index the view needs is turned off; student_cursor_next then yields
+// records in order and NULL once the view is exhausted.
+// students_in_gpa_range covers min_gpa <= gpa <= max_gpa.
+int students_by_gpa(StudentManager* manager, int descending, StudentCursor* cursor);
+int students_by_name(StudentManager* manager, StudentCursor* cursor);
+int students_in_gpa_range(StudentManager* manager, double min_gpa, double max_gpa,
+                          StudentCursor* cursor);
+int students_with_name_prefix(StudentManager* manager, const char* prefix, StudentCursor* cursor);
+Student* student_cursor_next(StudentCursor* cursor);
+
+// Text import/export (human-readable CSV-style format). For fast
+// persistence use the binary snapshot API in student_snapshot.h.
 int save_students_to_file(StudentManager* manager, const char* filename);
 int load_students_from_file(StudentManager* manager, const char* filename);
 
@@ -0,0 +1,137 @@
+#ifndef STUDENT_MANAGER_INTERNAL_H
+#define STUDENT_MANAGER_INTERNAL_H
+
+// Private view of StudentManager shared by the modules that implement it
+// (student_manager.c, student_snapshot.c, ...). Application code must only
+// include student_manager.h and treat the manager as opaque.
+
+#include "student_manager.h"
+#include "id_index.h"
+#include "ordered_index.h"
+#include "name_arena.h"
+#include "rw_lock.h"
+
+typedef struct StudentJournal StudentJournal;
+
+struct StudentManager {
+    StudentLayout layout;
+    int count;          // Slots in use, including removed ones...
+    int capacity;       // ...out of this many
+    int tombstones;     // Removed slots awaiting a purge (ID 0)
+    StudentRemovalMode removal_mode;
+    
+    // STUDENT_LAYOUT_ROWS: one array of complete records
+    Student* students;
+    
+    // STUDENT_LAYOUT_COLUMNS: one array per field, names in an arena
+    int* ids;
+    double* gpas;
+    uint32_t* name_offsets;
+    NameArena names;
+    
+    IdIndex id_index;   // Student ID -> slot
+    
+    // Incrementally maintained secondary indexes and statistics
+    int indexes;                    // STUDENT_INDEX_* flags in effect
+    OrderedIndex gpa_index;         // (GPA, ID) order for min/max and range queries
+    OrderedIndex name_index;        // (name, ID) order for name and prefix queries
+    double gpa_sum;                 // Running sum of all GPAs...
+    double gpa_sum_compensation;    // ...plus Neumaier error term
+    
+    RwLock* lock;               // Non-NULL in thread-safe mode
+    unsigned int generation;    // Bumped by every modification
+    StudentJournal* journal;    // Non-NULL while changes are journaled
+};
+
+static inline int live_student_count(const StudentManager* manager) {
+    return manager->count - manager->tombstones;
+}
+
+// Field access by slot, valid in either layout. Code outside the storage
+// helpers reads records only through these so column scans stay narrow.
+static inline int student_id_at(const StudentManager* manager, int slot) {
+    return manager->layout == STUDENT_LAYOUT_COLUMNS ? manager->ids[slot]
+                                                     : manager->students[slot].id;
+}
+
+static inline double student_gpa_at(const StudentManager* manager, int slot) {
+    return manager->layout == STUDENT_LAYOUT_COLUMNS ? manager->gpas[slot]
+                                                     : manager->students[slot].gpa;
+}
+
+static inline const char* student_name_at(const StudentManager* manager, int slot) {
+    return manager->layout == STUDENT_LAYOUT_COLUMNS
+        ? name_arena_get(&manager->names, manager->name_offsets[slot])
+        : manager->students[slot].name;
+}
+
+// Storage helpers
+// In the column layout store_student copies the name into the arena (or
+// shares an interned copy), which cannot fail once reserve_name_storage has
+// covered that many names and bytes.
+int reserve_student_slots(StudentManager* manager, int required);
+int reserve_name_storage(StudentManager* manager, int names, size_t bytes);
+void store_student(StudentManager* manager, int slot, const Student* student);
+void read_student(const StudentManager* manager, int slot, Student* student);
+Student* student_at(StudentManager* manager, int slot);
+void reindex_students(StudentManager* manager);
+// Code that walks slots 0..count must purge first, unless it skips ID 0;
+// readers get that from lock_students_for_scan
+void purge_tombstones(StudentManager* manager);
+// Copy of the records only (no indexes, statistics, lock or journal), taken
+// under lock_students_for_scan with a few bulk copies; it supports scans
+// and the file writers, not lookups or updates
+StudentManager* copy_student_records(const StudentManager* manager);
+// Whole-roster replacement: a load fills an empty manager with the same
+// layout, indexes, removal mode and interning, and only once that has
+// fully succeeded does replace_students_locked swap it in (keeping the
+// lock, generation and journal), journal the new roster and free the old
+// one. A failed load destroys the staging manager and changes nothing.
+StudentManager* create_staging_manager(const StudentManager* manager, int capacity_hint);
+void replace_students_locked(StudentManager* manager, StudentManager* staging);
+
+// Locking for thread-safe mode (no-ops otherwise). Every public entry point
+// takes one of these; the *_locked functions expect the exclusive lock to be
+// held already, for modules that combine several steps into one update.
+void lock_students_shared(StudentManager* manager);
+void unlock_students_shared(StudentManager* manager);
+void lock_students_exclusive(StudentManager* manager);
+void unlock_students_exclusive(StudentManager* manager);
+void lock_students_for_scan(StudentManager* manager);
+int add_student_locked(StudentManager* manager, int id, const char* name, double gpa);
+int remove_student_locked(StudentManager* manager, int id);
+int update_student_gpa_locked(StudentManager* manager, int id, double new_gpa);
+int add_students_batch_locked(StudentManager* manager, const Student* students, int n,
+                              StudentBatchReport* report);
+void clear_all_students_locked(StudentManager* manager);
+int save_students_to_file_locked(StudentManager* manager, const char* filename);
+int save_students_snapshot_locked(StudentManager* manager, const char* filename);
+int load_students_snapshot_locked(StudentManager* manager, const char* filename,
+                                  uint64_t* journal_sequence);
+
+// Journal hooks (student_journal.c), no-ops without an attached journal.
+// Each successful change is logged by the function that makes it. Loads
+// that replace the whole roster log nothing while they build it: they go
+// through replace_students_locked, which logs CLEAR and the new records
+// together once the load has succeeded, so a failed load never reaches
+// the journal. journal_commit flushes the records as the exclusive lock is
+// released and checkpoints once the journal has outgrown the roster. Snapshots are
+// stamped with journal_sequence so replay can skip what they contain.
+void journal_log_students(StudentManager* manager, int first_slot, int n);
+void journal_log_removal(StudentManager* manager, int id);
+void journal_log_gpa(StudentManager* manager, int id, double gpa);
+void journal_log_clear(StudentManager* manager);
+void journal_commit(StudentManager* manager);
+uint64_t journal_sequence(const StudentManager* manager);
+void journal_free(StudentManager* manager);
+
+// Secondary index and statistics maintenance. Every path that adds, removes
+// or re-grades a record must go through these so the running sum and both
+// orderings stay exact. index_students_bulk covers the n records stored
+// from first_slot onwards.
+int index_student(StudentManager* manager, int slot);
+int index_students_bulk(StudentManager* manager, int first_slot, int n);
+void unindex_student(StudentManager* manager, int slot);
+int set_student_gpa(StudentManager* manager, int slot, double gpa);
+
+#endif // STUDENT_MANAGER_INTERNAL_H
@@ -0,0 +1,416 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "student_query.h"
+#include "student_manager_internal.h"
+#include "config.h"
+
+// Probing every ID of a range beats a scan once the range is this many
+// times smaller than the roster
+#define ID_PROBE_RATIO 8
+// GPA ranges up to this fraction of the scale are walked in the GPA index
+#define GPA_INDEX_FRACTION 0.125
+
+#define BLOCK_WORDS (STUDENT_QUERY_BLOCK / 64)
+
+// Index of the lowest set bit of a non-zero word
+static inline int lowest_bit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int i = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+// Building queries
+void student_query_init(StudentQuery* query) {
+    if (query != NULL) {
+        query->term_count = 0;
+        query->clause_count = 1;
+    }
+}
+
+static StudentQueryTerm* add_term(StudentQuery* query, StudentQueryTermType type) {
+    if (query == NULL || query->term_count == MAX_STUDENT_QUERY_TERMS) {
+        DEBUG_PRINT("Query is full or missing");
+        return NULL;
+    }
+
+    StudentQueryTerm* term = &query->terms[query->term_count++];
+    memset(term, 0, sizeof(*term));
+    term->type = type;
+    term->clause = query->clause_count - 1;
+    return term;
+}
+
+int student_query_id_range(StudentQuery* query, int min_id, int max_id) {
+    StudentQueryTerm* term = add_term(query, STUDENT_QUERY_ID_RANGE);
+    if (term == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+    term->min_id = min_id;
+    term->max_id = max_id;
+    return SUCCESS;
+}
+
+int student_query_gpa_range(StudentQuery* query, double min_gpa, double max_gpa) {
+    if (isnan(min_gpa) || isnan(max_gpa)) {
+        return ERROR_INVALID_INPUT;
+    }
+    StudentQueryTerm* term = add_term(query, STUDENT_QUERY_GPA_RANGE);
+    if (term == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+    term->min_gpa = min_gpa;
+    term->max_gpa = max_gpa;
+    return SUCCESS;
+}
+
+static int add_text_term(StudentQuery* query, StudentQueryTermType type, const char* text) {
+    if (text == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+    StudentQueryTerm* term = add_term(query, type);
+    if (term == NULL) {
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Stored names are shorter than MAX_NAME_LENGTH, so longer text never matches
+    size_t length = strlen(text);
+    if (length >= MAX_NAME_LENGTH) {
+        term->text_length = MAX_NAME_LENGTH;
+    } else {
+        memcpy(term->text, text, length + 1);
+        term->text_length = length;
+    }
+    return SUCCESS;
+}
+
+int student_query_name_prefix(StudentQuery* query, const char* prefix) {
+    return add_text_term(query, STUDENT_QUERY_NAME_PREFIX, prefix);
+}
+
+int student_query_name_contains(StudentQuery* query, const char* text) {
+    return add_text_term(query, STUDENT_QUERY_NAME_CONTAINS, text);
+}
+
+int student_query_or(StudentQuery* query) {
+    if (query == NULL || query->clause_count == MAX_STUDENT_QUERY_TERMS) {
+        return ERROR_INVALID_INPUT;
+    }
+    query->clause_count++;
+    return SUCCESS;
+}
+
+// Single-record evaluation, for candidates produced by an index
+static int name_term_matches(const StudentQueryTerm* term, const char* name) {
+    if (term->text_length == MAX_NAME_LENGTH) {
+        return 0;
+    }
+    if (term->type == STUDENT_QUERY_NAME_PREFIX) {
+        return strncmp(name, term->text, term->text_length) == 0;
+    }
+    return strstr(name, term->text) != NULL;
+}
+
+static int term_matches(const StudentManager* manager, const StudentQueryTerm* term, int slot) {
+    switch (term->type) {
+        case STUDENT_QUERY_ID_RANGE: {
+            int id = student_id_at(manager, slot);
+            return id >= term->min_id && id <= term->max_id;
+        }
+        case STUDENT_QUERY_GPA_RANGE: {
+            double gpa = student_gpa_at(manager, slot);
+            return gpa >= term->min_gpa && gpa <= term->max_gpa;
+        }
+        default:
+            return name_term_matches(term, student_name_at(manager, slot));
+    }
+}
+
+// Whether the record satisfies every term except the one that produced it
+static int other_terms_match(const StudentQueryCursor* cursor, int slot) {
+    for (int t = 0; t < cursor->query.term_count; t++) {
+        if (t != cursor->driver && !term_matches(cursor->manager, &cursor->query.terms[t], slot)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Block evaluation. Each term narrows a clause's mask over the whole block
+// by reading one column, so ID and GPA terms run as tight branch-free loops
+// and name terms only look at the slots still in the running.
+static void filter_block(const StudentManager* manager, const StudentQueryTerm* term,
+                         int start, int n, uint64_t* mask) {
+    uint64_t bits[BLOCK_WORDS] = {0};
+
+    if (term->type == STUDENT_QUERY_ID_RANGE) {
+        int buffer[STUDENT_QUERY_BLOCK];
+        const int* ids = buffer;
+        if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+            ids = &manager->ids[start];
+        } else {
+            for (int i = 0; i < n; i++) {
+                buffer[i] = manager->students[start + i].id;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            bits[i >> 6] |= (uint64_t)(ids[i] >= term->min_id && ids[i] <= term->max_id) << (i & 63);
+        }
+    } else if (term->type == STUDENT_QUERY_GPA_RANGE) {
+        double buffer[STUDENT_QUERY_BLOCK];
+        const double* gpas = buffer;
+        if (manager->layout == STUDENT_LAYOUT_COLUMNS) {
+            gpas = &manager->gpas[start];
+        } else {
+            for (int i = 0; i < n; i++) {
+                buffer[i] = manager->students[start + i].gpa;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            bits[i >> 6] |= (uint64_t)(gpas[i] >= term->min_gpa && gpas[i] <= term->max_gpa) << (i & 63);
+        }
+    } else {
+        for (int w = 0; w < BLOCK_WORDS; w++) {
+            for (uint64_t pending = mask[w]; pending != 0; pending &= pending - 1) {
+                int bit = lowest_bit(pending);
+                if (name_term_matches(term, student_name_at(manager, start + w * 64 + bit))) {
+                    bits[w] |= UINT64_C(1) << bit;
+                }
+            }
+        }
+    }
+
+    for (int w = 0; w < BLOCK_WORDS; w++) {
+        mask[w] &= bits[w];
+    }
+}
+
+// Evaluate blocks until one has a match; returns 0 at the end of the roster
+static int scan_next_block(StudentQueryCursor* cursor) {
+    const StudentManager* manager = cursor->manager;
+    const StudentQuery* query = &cursor->query;
+
+    while (cursor->next_slot < manager->count) {
+        int start = cursor->next_slot;
+        int n = manager->count - start < STUDENT_QUERY_BLOCK ? manager->count - start : STUDENT_QUERY_BLOCK;
+        cursor->next_slot += n;
+
+        uint64_t block[BLOCK_WORDS] = {0};
+        for (int clause = 0; clause < query->clause_count; clause++) {
+            uint64_t mask[BLOCK_WORDS];
+            for (int w = 0; w < BLOCK_WORDS; w++) {
+                int bits = n - w * 64;
+                mask[w] = bits >= 64 ? UINT64_MAX : bits > 0 ? (UINT64_C(1) << bits) - 1 : 0;
+            }
+            for (int t = 0; t < query->term_count; t++) {
+                if (query->terms[t].clause == clause) {
+                    filter_block(manager, &query->terms[t], start, n, mask);
+                }
+            }
+            for (int w = 0; w < BLOCK_WORDS; w++) {
+                block[w] |= mask[w];
+            }
+        }
+
+        int any = 0;
+        for (int w = 0; w < BLOCK_WORDS; w++) {
+            cursor->matches[w] = block[w];
+            any |= block[w] != 0;
+        }
+        if (any) {
+            cursor->block_start = start;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Pop the lowest pending match of the current block
+static int take_scan_match(StudentQueryCursor* cursor) {
+    for (int w = 0; w < BLOCK_WORDS; w++) {
+        uint64_t word = cursor->matches[w];
+        if (word != 0) {
+            cursor->matches[w] &= word - 1;
+            return cursor->block_start + w * 64 + lowest_bit(word);
+        }
+    }
+    return -1;
+}
+
+// Planning. Only single-clause queries use an index: a union of several
+// index walks would need a buffer to drop the records found twice.
+static void plan_query(StudentQueryCursor* cursor) {
+    const StudentManager* manager = cursor->manager;
+    const StudentQuery* query = &cursor->query;
+    cursor->plan = STUDENT_QUERY_PLAN_SCAN;
+    cursor->driver = -1;
+    if (query->clause_count != 1) {
+        return;
+    }
+
+    int live = live_student_count(manager);
+    for (int t = 0; t < query->term_count; t++) {
+        const StudentQueryTerm* term = &query->terms[t];
+        if (term->type == STUDENT_QUERY_ID_RANGE && term->min_id <= term->max_id &&
+            (long long)term->max_id - term->min_id < live / ID_PROBE_RATIO) {
+            cursor->plan = STUDENT_QUERY_PLAN_ID_PROBE;
+            cursor->driver = t;
+            return;
+        }
+    }
+    for (int t = 0; t < query->term_count; t++) {
+        const StudentQueryTerm* term = &query->terms[t];
+        if (term->type == STUDENT_QUERY_NAME_PREFIX && term->text_length > 0 &&
+            term->text_length < MAX_NAME_LENGTH && (manager->indexes & STUDENT_INDEX_NAME)) {
+            cursor->plan = STUDENT_QUERY_PLAN_NAME_INDEX;
+            cursor->driver = t;
+            return;
+        }
+    }
+    for (int t = 0; t < query->term_count; t++) {
+        const StudentQueryTerm* term = &query->terms[t];
+        if (term->type == STUDENT_QUERY_GPA_RANGE && (manager->indexes & STUDENT_INDEX_GPA) &&
+            term->max_gpa - term->min_gpa <= (MAX_GPA - MIN_GPA) * GPA_INDEX_FRACTION) {
+            cursor->plan = STUDENT_QUERY_PLAN_GPA_INDEX;
+            cursor->driver = t;
+            return;
+        }
+    }
+}
+
+// Running queries
+static int query_students_locked(StudentManager* manager, const StudentQuery* query,
+                                 StudentQueryCursor* cursor) {
+    if (manager == NULL || query == NULL || cursor == NULL ||
+        query->term_count < 0 || query->term_count > MAX_STUDENT_QUERY_TERMS) {
+        DEBUG_PRINT("Invalid parameters for query_students");
+        return ERROR_INVALID_INPUT;
+    }
+
+    cursor->manager = manager;
+    cursor->query = *query;
+    cursor->generation = manager->generation;
+    cursor->next_slot = 0;
+    cursor->block_start = 0;
+    memset(cursor->matches, 0, sizeof(cursor->matches));
+    cursor->position = NULL;
+    cursor->next_id = 0;
+    plan_query(cursor);
+
+    if (cursor->plan == STUDENT_QUERY_PLAN_ID_PROBE) {
+        int min_id = cursor->query.terms[cursor->driver].min_id;
+        cursor->next_id = min_id > 1 ? min_id : 1;
+    } else if (cursor->plan == STUDENT_QUERY_PLAN_NAME_INDEX) {
+        cursor->position = ordered_index_lower_bound_text(&manager->name_index,
+                                                          cursor->query.terms[cursor->driver].text);
+    } else if (cursor->plan == STUDENT_QUERY_PLAN_GPA_INDEX) {
+        cursor->position = ordered_index_lower_bound(&manager->gpa_index,
+                                                     cursor->query.terms[cursor->driver].min_gpa);
+    }
+    DEBUG_PRINT("Query planned as %d", (int)cursor->plan);
+    return SUCCESS;
+}
+
+// Scans walk slots, so they start on a roster without removed ones; any
+// later removal changes the generation and ends the cursor
+int query_students(StudentManager* manager, const StudentQuery* query, StudentQueryCursor* cursor) {
+    lock_students_for_scan(manager);
+    int result = query_students_locked(manager, query, cursor);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static int next_index_match(StudentQueryCursor* cursor) {
+    StudentManager* manager = cursor->manager;
+    const StudentQueryTerm* driver = &cursor->query.terms[cursor->driver];
+    const OrderedIndex* index = cursor->plan == STUDENT_QUERY_PLAN_NAME_INDEX
+        ? &manager->name_index : &manager->gpa_index;
+
+    while (cursor->position != NULL) {
+        const OrderedNode* node = cursor->position;
+        if (cursor->plan == STUDENT_QUERY_PLAN_NAME_INDEX
+                ? strncmp(node->text, driver->text, driver->text_length) != 0
+                : node->key > driver->max_gpa) {
+            break;
+        }
+        cursor->position = ordered_index_next(index, node);
+
+        int slot = id_index_find(&manager->id_index, node->id);
+        if (other_terms_match(cursor, slot)) {
+            return slot;
+        }
+    }
+    cursor->position = NULL;
+    return -1;
+}
+
+static int next_probe_match(StudentQueryCursor* cursor) {
+    StudentManager* manager = cursor->manager;
+    int max_id = cursor->query.terms[cursor->driver].max_id;
+    if (max_id > MAX_STUDENT_ID) {
+        max_id = MAX_STUDENT_ID;
+    }
+
+    while (cursor->next_id <= max_id) {
+        int id = cursor->next_id++;
+        int slot = id_index_find(&manager->id_index, id);
+        if (slot != -1 && other_terms_match(cursor, slot)) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+static const Student* student_query_next_locked(StudentQueryCursor* cursor) {
+    if (cursor == NULL || cursor->manager == NULL) {
+        return NULL;
+    }
+
+    StudentManager* manager = cursor->manager;
+    if (cursor->generation != manager->generation) {
+        cursor->manager = NULL;
+        return NULL;
+    }
+
+    int slot;
+    switch (cursor->plan) {
+        case STUDENT_QUERY_PLAN_ID_PROBE:
+            slot = next_probe_match(cursor);
+            break;
+        case STUDENT_QUERY_PLAN_NAME_INDEX:
+        case STUDENT_QUERY_PLAN_GPA_INDEX:
+            slot = next_index_match(cursor);
+            break;
+        default:
+            slot = take_scan_match(cursor);
+            if (slot == -1 && scan_next_block(cursor)) {
+                slot = take_scan_match(cursor);
+            }
+            break;
+    }
+
+    if (slot == -1) {
+        cursor->manager = NULL;
+        return NULL;
+    }
+    return student_at(manager, slot);
+}
+
+const Student* student_query_next(StudentQueryCursor* cursor) {
+    StudentManager* manager = cursor != NULL ? cursor->manager : NULL;
+    lock_students_shared(manager);
+    const Student* result = student_query_next_locked(cursor);
+    unlock_students_shared(manager);
+    return result;
+}
+
+StudentQueryPlan get_student_query_plan(const StudentQueryCursor* cursor) {
+    return cursor != NULL ? cursor->plan : STUDENT_QUERY_PLAN_SCAN;
+}
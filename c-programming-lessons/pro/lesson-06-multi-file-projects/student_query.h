@@ -0,0 +1,89 @@
+#ifndef STUDENT_QUERY_H
+#define STUDENT_QUERY_H
+
+#include <stdint.h>
+#include "student_manager.h"
+
+// Filter queries over the roster. A query is an OR of clauses, each an AND
+// of terms: ID range, GPA range (both inclusive), name prefix or name
+// substring. Build one with student_query_init, add terms to the current
+// clause and call student_query_or to start the next clause:
+//
+//   gpa >= 3.5 AND name starts with "A"  OR  id in [1000, 1999]
+//
+//   student_query_init(&q);
+//   student_query_gpa_range(&q, 3.5, MAX_GPA);
+//   student_query_name_prefix(&q, "A");
+//   student_query_or(&q);
+//   student_query_id_range(&q, 1000, 1999);
+//
+// An empty clause matches every student. Queries and cursors are plain
+// caller-owned structs, so running a query allocates nothing.
+#define MAX_STUDENT_QUERY_TERMS 8
+
+typedef enum {
+    STUDENT_QUERY_ID_RANGE,
+    STUDENT_QUERY_GPA_RANGE,
+    STUDENT_QUERY_NAME_PREFIX,
+    STUDENT_QUERY_NAME_CONTAINS
+} StudentQueryTermType;
+
+typedef struct {
+    StudentQueryTermType type;
+    int clause;                     // Terms of one clause are ANDed
+    int min_id, max_id;
+    double min_gpa, max_gpa;
+    char text[MAX_NAME_LENGTH];     // Prefix or substring
+    size_t text_length;             // MAX_NAME_LENGTH if no name can match
+} StudentQueryTerm;
+
+typedef struct {
+    StudentQueryTerm terms[MAX_STUDENT_QUERY_TERMS];
+    int term_count;
+    int clause_count;
+} StudentQuery;
+
+// Building queries. Adding a term returns ERROR_INVALID_INPUT once
+// MAX_STUDENT_QUERY_TERMS are in use, or for a NaN bound or NULL text.
+void student_query_init(StudentQuery* query);
+int student_query_id_range(StudentQuery* query, int min_id, int max_id);
+int student_query_gpa_range(StudentQuery* query, double min_gpa, double max_gpa);
+int student_query_name_prefix(StudentQuery* query, const char* prefix);
+int student_query_name_contains(StudentQuery* query, const char* text);
+int student_query_or(StudentQuery* query);
+
+// Running queries
+// A single-clause query with a narrow ID range probes the ID index for each
+// ID in it; one with a name prefix, or a narrow GPA range, walks the
+// matching stretch of the name or GPA index when that index is on. Every
+// other query scans the roster a block at a time, evaluating each term over
+// a whole column of the block before moving on. Results come in ID order,
+// index order or storage order respectively. As with the ordered views,
+// any modification of the manager ends an open cursor.
+#define STUDENT_QUERY_BLOCK 256
+
+typedef enum {
+    STUDENT_QUERY_PLAN_SCAN,
+    STUDENT_QUERY_PLAN_ID_PROBE,
+    STUDENT_QUERY_PLAN_NAME_INDEX,
+    STUDENT_QUERY_PLAN_GPA_INDEX
+} StudentQueryPlan;
+
+typedef struct {
+    StudentManager* manager;
+    StudentQuery query;             // Private copy
+    StudentQueryPlan plan;
+    unsigned int generation;        // Manager state the cursor was opened on
+    int next_slot;                  // Scan: first slot of the next block
+    int block_start;                // Scan: first slot of the current block
+    uint64_t matches[STUDENT_QUERY_BLOCK / 64];     // Scan: unreported matches
+    const void* position;           // Index walks: next index entry
+    int next_id;                    // ID probe: next ID to look up
+    int driver;                     // Term answered by the index or ID probe
+} StudentQueryCursor;
+
+int query_students(StudentManager* manager, const StudentQuery* query, StudentQueryCursor* cursor);
+const Student* student_query_next(StudentQueryCursor* cursor);
+StudentQueryPlan get_student_query_plan(const StudentQueryCursor* cursor);
+
+#endif // STUDENT_QUERY_H
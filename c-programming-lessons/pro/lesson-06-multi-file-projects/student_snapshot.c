@@ -0,0 +1,338 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "student_snapshot.h"
+#include "student_manager_internal.h"
+#include "mapped_file.h"
+#include "config.h"
+
+#define SNAPSHOT_WRITE_BATCH 4096
+#define FLETCHER_MODULUS 0xFFFFFFFFull
+#define FLETCHER_BLOCK_WORDS 65536  // Words summed before sum2 could overflow
+
+_Static_assert(sizeof(StudentSnapshotHeader) == 64, "snapshot header must stay 64 bytes");
+_Static_assert(sizeof(StudentSnapshotRecord) == 16, "snapshot records must stay 16 bytes");
+
+// Streaming Fletcher-64 state so the writer can checksum while it writes.
+// Writes are not word-aligned, so up to three trailing bytes are carried over.
+typedef struct {
+    uint64_t sum1;
+    uint64_t sum2;
+    unsigned char pending[4];
+    size_t pending_length;
+} ChecksumState;
+
+static void checksum_words(ChecksumState* state, const unsigned char* bytes, size_t words) {
+    while (words > 0) {
+        size_t block = words < FLETCHER_BLOCK_WORDS ? words : FLETCHER_BLOCK_WORDS;
+        for (size_t i = 0; i < block; i++) {
+            uint32_t word;
+            memcpy(&word, bytes + i * 4, sizeof(word));
+            state->sum1 += word;
+            state->sum2 += state->sum1;
+        }
+        state->sum1 %= FLETCHER_MODULUS;
+        state->sum2 %= FLETCHER_MODULUS;
+        bytes += block * 4;
+        words -= block;
+    }
+}
+
+static void checksum_update(ChecksumState* state, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+
+    // Complete a word left over from the previous call first
+    while (state->pending_length > 0 && size > 0) {
+        state->pending[state->pending_length++] = *bytes++;
+        size--;
+        if (state->pending_length == 4) {
+            checksum_words(state, state->pending, 1);
+            state->pending_length = 0;
+        }
+    }
+
+    checksum_words(state, bytes, size / 4);
+    bytes += size & ~(size_t)3;
+    size &= 3;
+
+    memcpy(state->pending, bytes, size);
+    state->pending_length += size;
+}
+
+static uint64_t checksum_final(const ChecksumState* state) {
+    return (state->sum2 << 32) | state->sum1;
+}
+
+uint64_t snapshot_checksum(const void* data, size_t size) {
+    ChecksumState state = {0, 0, {0}, 0};
+    checksum_update(&state, data, size);
+    return checksum_final(&state);
+}
+
+static size_t padded_blob_size(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+static int write_checked(FILE* file, ChecksumState* state, const void* data, size_t size) {
+    if (state != NULL) {
+        checksum_update(state, data, size);
+    }
+    return fwrite(data, 1, size, file) == size ? SUCCESS : ERROR_FILE_IO;
+}
+
+static int write_snapshot_body(StudentManager* manager, FILE* file, StudentSnapshotHeader* header) {
+    ChecksumState state = {0, 0, {0}, 0};
+    StudentSnapshotRecord batch[SNAPSHOT_WRITE_BATCH];
+    size_t name_offset = 0;
+    int result = SUCCESS;
+
+    // Records: names are laid out in the blob in record order
+    for (int start = 0; start < manager->count && result == SUCCESS; start += SNAPSHOT_WRITE_BATCH) {
+        int end = start + SNAPSHOT_WRITE_BATCH < manager->count ? start + SNAPSHOT_WRITE_BATCH : manager->count;
+        for (int i = start; i < end; i++) {
+            StudentSnapshotRecord* record = &batch[i - start];
+            memset(record, 0, sizeof(*record));
+            record->id = student_id_at(manager, i);
+            record->name_offset = (uint32_t)name_offset;
+            record->gpa = student_gpa_at(manager, i);
+            name_offset += strlen(student_name_at(manager, i)) + 1;
+        }
+        result = write_checked(file, &state, batch, (size_t)(end - start) * sizeof(StudentSnapshotRecord));
+    }
+
+    if (name_offset > UINT32_MAX) {
+        DEBUG_PRINT("Name blob too large for snapshot format: %zu bytes", name_offset);
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Name blob, staged through the same buffer to keep writes large
+    char* staging = (char*)batch;
+    size_t staged = 0;
+    for (int i = 0; i < manager->count && result == SUCCESS; i++) {
+        const char* name = student_name_at(manager, i);
+        size_t length = strlen(name) + 1;
+        if (staged + length > sizeof(batch)) {
+            result = write_checked(file, &state, staging, staged);
+            staged = 0;
+        }
+        memcpy(staging + staged, name, length);
+        staged += length;
+    }
+
+    if (result == SUCCESS && staged > 0) {
+        result = write_checked(file, &state, staging, staged);
+    }
+
+    size_t blob_size = padded_blob_size(name_offset);
+    static const char zeros[8] = {0};
+    if (result == SUCCESS && blob_size > name_offset) {
+        result = write_checked(file, &state, zeros, blob_size - name_offset);
+    }
+
+    header->record_count = (uint64_t)manager->count;
+    header->name_blob_size = blob_size;
+    header->checksum = checksum_final(&state);
+    return result;
+}
+
+// Snapshot persistence
+int save_students_snapshot_locked(StudentManager* manager, const char* filename) {
+    DEBUG_PRINT("Saving snapshot to file: %s", filename);
+
+    if (manager == NULL || filename == NULL) {
+        DEBUG_PRINT("Invalid parameters for save_students_snapshot");
+        return ERROR_INVALID_INPUT;
+    }
+
+    // Write to a side file and rename so a crash never leaves a torn snapshot
+    size_t name_length = strlen(filename);
+    char* temp_name = malloc(name_length + 5);
+    if (temp_name == NULL) {
+        return ERROR_MEMORY_ALLOCATION;
+    }
+    memcpy(temp_name, filename, name_length);
+    memcpy(temp_name + name_length, ".tmp", 5);
+
+    FILE* file = fopen(temp_name, "wb");
+    if (file == NULL) {
+        DEBUG_PRINT("Failed to open file for writing: %s", temp_name);
+        free(temp_name);
+        return ERROR_FILE_NOT_FOUND;
+    }
+
+    StudentSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(StudentSnapshotHeader);
+    header.record_size = sizeof(StudentSnapshotRecord);
+    header.journal_sequence = journal_sequence(manager);
+
+    // Reserve the header, stream the body, then fill in sizes and checksum
+    int result = write_checked(file, NULL, &header, sizeof(header));
+    if (result == SUCCESS) {
+        result = write_snapshot_body(manager, file, &header);
+    }
+    if (result == SUCCESS) {
+        if (fseek(file, 0, SEEK_SET) != 0) {
+            result = ERROR_FILE_IO;
+        } else {
+            result = write_checked(file, NULL, &header, sizeof(header));
+        }
+    }
+    if (result == SUCCESS) {
+        result = sync_file(file);
+    }
+    if (fclose(file) != 0 && result == SUCCESS) {
+        result = ERROR_FILE_IO;
+    }
+
+#ifdef _WIN32
+    if (result == SUCCESS) {
+        remove(filename);  // rename() does not replace existing files on Windows
+    }
+#endif
+    if (result == SUCCESS && rename(temp_name, filename) != 0) {
+        result = ERROR_FILE_IO;
+    }
+    if (result != SUCCESS) {
+        DEBUG_PRINT("Failed to write snapshot: %s", filename);
+        remove(temp_name);
+    }
+
+    free(temp_name);
+    DEBUG_PRINT("Saved %d students to snapshot", manager->count);
+    return result;
+}
+
+int save_students_snapshot(StudentManager* manager, const char* filename) {
+    lock_students_for_scan(manager);
+    int result = save_students_snapshot_locked(manager, filename);
+    unlock_students_shared(manager);
+    return result;
+}
+
+static int validate_header(const StudentSnapshotHeader* header, size_t file_size) {
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        DEBUG_PRINT("Snapshot magic mismatch");
+        return ERROR_FILE_CORRUPT;
+    }
+    if (header->version != SNAPSHOT_VERSION ||
+        header->header_size != sizeof(StudentSnapshotHeader) ||
+        header->record_size != sizeof(StudentSnapshotRecord)) {
+        DEBUG_PRINT("Unsupported snapshot version %u", (unsigned)header->version);
+        return ERROR_FILE_CORRUPT;
+    }
+
+    // Guard the size arithmetic before trusting the counts
+    size_t body = file_size - sizeof(StudentSnapshotHeader);
+    if (header->record_count > body / sizeof(StudentSnapshotRecord) ||
+        header->record_count > (uint64_t)INT32_MAX ||
+        header->name_blob_size % 8 != 0 ||
+        header->name_blob_size > UINT32_MAX ||
+        header->record_count * sizeof(StudentSnapshotRecord) + header->name_blob_size != body) {
+        DEBUG_PRINT("Snapshot sizes do not match file length");
+        return ERROR_FILE_CORRUPT;
+    }
+    return SUCCESS;
+}
+
+int load_students_snapshot_locked(StudentManager* manager, const char* filename,
+                                  uint64_t* journal_sequence) {
+    DEBUG_PRINT("Loading snapshot from file: %s", filename);
+
+    if (manager == NULL || filename == NULL) {
+        DEBUG_PRINT("Invalid parameters for load_students_snapshot");
+        return ERROR_INVALID_INPUT;
+    }
+
+    MappedFile file;
+    int result = map_file_readonly(filename, &file);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    if (file.size < sizeof(StudentSnapshotHeader)) {
+        unmap_file(&file);
+        return ERROR_FILE_CORRUPT;
+    }
+
+    StudentSnapshotHeader header;
+    memcpy(&header, file.data, sizeof(header));
+    result = validate_header(&header, file.size);
+
+    const unsigned char* body = (const unsigned char*)file.data + sizeof(header);
+    size_t body_size = file.size - sizeof(header);
+    if (result == SUCCESS && snapshot_checksum(body, body_size) != header.checksum) {
+        DEBUG_PRINT("Snapshot checksum mismatch");
+        result = ERROR_FILE_CORRUPT;
+    }
+    if (result != SUCCESS) {
+        unmap_file(&file);
+        return result;
+    }
+
+    // Records are checked and indexed in a staging manager; the existing
+    // roster is only replaced once every one of them has been accepted
+    int count = (int)header.record_count;
+    StudentManager* staging = create_staging_manager(manager, count);
+    if (staging == NULL ||
+        reserve_name_storage(staging, count, (size_t)header.name_blob_size + (size_t)count) != SUCCESS) {
+        destroy_student_manager(staging);
+        unmap_file(&file);
+        return ERROR_MEMORY_ALLOCATION;
+    }
+
+    const StudentSnapshotRecord* records = (const StudentSnapshotRecord*)body;
+    const char* blob = (const char*)(records + count);
+    size_t blob_size = (size_t)header.name_blob_size;
+
+    for (int i = 0; i < count && result == SUCCESS; i++) {
+        const StudentSnapshotRecord* record = &records[i];
+        size_t available = record->name_offset < blob_size ? blob_size - record->name_offset : 0;
+        const char* name = blob + record->name_offset;
+        const char* terminator = available ? memchr(name, '\0', available < MAX_NAME_LENGTH ? available : MAX_NAME_LENGTH) : NULL;
+
+        if (terminator == NULL || !is_valid_student_id(record->id) || !is_valid_gpa(record->gpa)) {
+            DEBUG_PRINT("Corrupt snapshot record at index %d", i);
+            result = ERROR_FILE_CORRUPT;
+            break;
+        }
+
+        Student student;
+        student.id = record->id;
+        memcpy(student.name, name, (size_t)(terminator - name) + 1);
+        student.gpa = record->gpa;
+        store_student(staging, i, &student);
+
+        result = id_index_insert(&staging->id_index, student.id, i);
+        if (result == ERROR_STUDENT_EXISTS) {
+            DEBUG_PRINT("Duplicate student ID %d in snapshot", student.id);
+            result = ERROR_FILE_CORRUPT;
+        }
+        staging->count = i + 1;
+    }
+
+    unmap_file(&file);
+    if (result == SUCCESS) {
+        result = index_students_bulk(staging, 0, count);
+    }
+    if (result != SUCCESS) {
+        destroy_student_manager(staging);
+        return result;
+    }
+
+    replace_students_locked(manager, staging);
+    if (journal_sequence != NULL) {
+        *journal_sequence = header.journal_sequence;
+    }
+    DEBUG_PRINT("Loaded %d students from snapshot", manager->count);
+    return SUCCESS;
+}
+
+int load_students_snapshot(StudentManager* manager, const char* filename) {
+    lock_students_exclusive(manager);
+    int result = load_students_snapshot_locked(manager, filename, NULL);
+    unlock_students_exclusive(manager);
+    return result;
+}
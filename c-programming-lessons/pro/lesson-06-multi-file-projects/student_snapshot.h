@@ -0,0 +1,44 @@
+#ifndef STUDENT_SNAPSHOT_H
+#define STUDENT_SNAPSHOT_H
+
+#include <stdint.h>
+#include "student_manager.h"
+
+// Binary roster snapshot (version 1), all integers in host byte order:
+//
+//   StudentSnapshotHeader                      64 bytes
+//   StudentSnapshotRecord[record_count]        16 bytes each
+//   name blob                                  NUL-terminated names, padded to 8
+//
+// The checksum covers everything after the header. Loading maps the file and
+// copies records straight into the manager without any text parsing.
+#define SNAPSHOT_MAGIC "STUDSNAP"
+#define SNAPSHOT_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t record_size;
+    uint32_t reserved;
+    uint64_t record_count;
+    uint64_t name_blob_size;
+    uint64_t checksum;
+    uint64_t journal_sequence;  // Last journal record included, 0 if none
+    uint8_t padding[8];
+} StudentSnapshotHeader;
+
+typedef struct {
+    int32_t id;
+    uint32_t name_offset;   // Byte offset of the name inside the blob
+    double gpa;
+} StudentSnapshotRecord;
+
+// Snapshot persistence
+int save_students_snapshot(StudentManager* manager, const char* filename);
+int load_students_snapshot(StudentManager* manager, const char* filename);
+
+// Integrity helper (Fletcher-64 over 32-bit words; size must be a multiple of 4)
+uint64_t snapshot_checksum(const void* data, size_t size);
+
+#endif // STUDENT_SNAPSHOT_H